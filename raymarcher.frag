@@ -11,13 +11,17 @@ uniform float u_time;
 #define ASPECT_RATIO u_resolution.x / u_resolution.y
 #define FOV 10.0
 
-#define PI 3.14159265359 
-
 #define MAX_STEPS 128
 #define EPSILON 0.001
 #define MAX_DIST 500.0
 
 
+// ----------------------- Includes ----------------------
+
+#include "src/shaders/common/math.glsl"
+#include "src/shaders/common/sdf.glsl"
+
+
 // -------------------- Structs --------------------------
 
 
@@ -27,27 +31,6 @@ struct Ray {
 };
 
 
-// ------------------ Ray Marching Opperations -----------
-
-
-float smin(float a, float b, float k) {
-    float h = max(k-abs(a-b), 0.0)/k;
-    return min(a,b) - h*h*h*k*(1.0/6.0);
-}
-
-
-// ------------------------- Helpers ---------------------
-
-float circleSDF(vec3 position, float radius) {
-	return length(position) - radius;
-}
-
-float sdBox( vec3 p, vec3 b )
-{
-  vec3 q = abs(p) - b;
-  return length(max(q,0.0)) + min(max(q.x,max(q.y,q.z)),0.0);
-}
-
 float map(vec3 position, float radius) {
 
     float distOne = circleSDF(
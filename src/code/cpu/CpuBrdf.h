@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CpuMath.h"
+
+// common/brdf.glsl and common/tonemap.glsl in C++
+
+// N
+// Normal distrubution
+inline float distributionGGX(const Vec3 &N, const Vec3 &H, float roughness) {
+    float a2 = roughness * roughness * roughness * roughness;
+    float NdotH = std::max(dot(N, H), 0.0f);
+    float denom = (NdotH * NdotH * (a2 - 1.0f) + 1.0f);
+    return a2 / (PI * denom * denom);
+}
+
+// G
+// Geometry
+inline float geometrySchlickGGX(float NdotV, float roughness) {
+    float r = (roughness + 1.0f);
+    float k = (r * r) / 8.0f;
+    return NdotV / (NdotV * (1.0f - k) + k);
+}
+
+inline float geometrySmith(const Vec3 &N, const Vec3 &V, const Vec3 &L, float roughness) {
+    return geometrySchlickGGX(std::max(dot(N, L), 0.0f), roughness) *
+           geometrySchlickGGX(std::max(dot(N, V), 0.0f), roughness);
+}
+
+// F
+// Frensel
+inline Vec3 fresnelSchlick(float cosTheta, const Vec3 &F0) {
+    return F0 + (Vec3(1.0f) - F0) * std::pow(1.0f - cosTheta, 5.0f);
+}
+
+// Reinhard then gamma 2.2 (fragment.frag's curve)
+inline Vec3 ReinhardGamma(Vec3 color) {
+    color = color / (color + Vec3(1.0f));
+    return pow(color, Vec3(1.0f / 2.2f));
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+// Just enough of GLSL's vector math to port the shaders line for line
+// Everything is float like on the GPU so results stay as close as possible
+
+#ifndef PI
+#define PI 3.14159265359f
+#endif
+
+#ifndef TWO_PI
+#define TWO_PI 6.28318530718f
+#endif
+
+struct Vec2 {
+    float x, y;
+
+    Vec2() : x(0.0f), y(0.0f) {};
+    Vec2(float v) : x(v), y(v) {};
+    Vec2(float x, float y) : x(x), y(y) {};
+};
+
+struct Vec3 {
+    float x, y, z;
+
+    Vec3() : x(0.0f), y(0.0f), z(0.0f) {};
+    Vec3(float v) : x(v), y(v), z(v) {};
+    Vec3(float x, float y, float z) : x(x), y(y), z(z) {};
+    Vec3(const float v[3]) : x(v[0]), y(v[1]), z(v[2]) {};
+
+    Vec3& operator+=(const Vec3 &o) { x += o.x; y += o.y; z += o.z; return *this; };
+    Vec3& operator*=(const Vec3 &o) { x *= o.x; y *= o.y; z *= o.z; return *this; };
+    Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; };
+};
+
+// Vec2
+inline Vec2 operator+(const Vec2 &a, const Vec2 &b) { return Vec2(a.x + b.x, a.y + b.y); }
+inline Vec2 operator-(const Vec2 &a, const Vec2 &b) { return Vec2(a.x - b.x, a.y - b.y); }
+inline Vec2 operator*(const Vec2 &a, const Vec2 &b) { return Vec2(a.x * b.x, a.y * b.y); }
+inline Vec2 operator/(const Vec2 &a, const Vec2 &b) { return Vec2(a.x / b.x, a.y / b.y); }
+inline Vec2 operator*(const Vec2 &a, float s) { return Vec2(a.x * s, a.y * s); }
+inline Vec2 operator/(const Vec2 &a, float s) { return Vec2(a.x / s, a.y / s); }
+inline Vec2 operator-(const Vec2 &a, float s) { return Vec2(a.x - s, a.y - s); }
+
+// Vec3
+inline Vec3 operator+(const Vec3 &a, const Vec3 &b) { return Vec3(a.x + b.x, a.y + b.y, a.z + b.z); }
+inline Vec3 operator-(const Vec3 &a, const Vec3 &b) { return Vec3(a.x - b.x, a.y - b.y, a.z - b.z); }
+inline Vec3 operator*(const Vec3 &a, const Vec3 &b) { return Vec3(a.x * b.x, a.y * b.y, a.z * b.z); }
+inline Vec3 operator/(const Vec3 &a, const Vec3 &b) { return Vec3(a.x / b.x, a.y / b.y, a.z / b.z); }
+inline Vec3 operator*(const Vec3 &a, float s) { return Vec3(a.x * s, a.y * s, a.z * s); }
+inline Vec3 operator*(float s, const Vec3 &a) { return Vec3(a.x * s, a.y * s, a.z * s); }
+inline Vec3 operator/(const Vec3 &a, float s) { return Vec3(a.x / s, a.y / s, a.z / s); }
+inline Vec3 operator-(const Vec3 &a) { return Vec3(-a.x, -a.y, -a.z); }
+
+// GLSL built ins
+inline float dot(const Vec3 &a, const Vec3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline float length(const Vec3 &a) { return std::sqrt(dot(a, a)); }
+inline Vec3 normalize(const Vec3 &a) { return a / length(a); }
+
+inline float mix(float a, float b, float t) { return a + (b - a) * t; }
+inline Vec3 mix(const Vec3 &a, const Vec3 &b, float t) { return a + (b - a) * t; }
+inline Vec3 mix(const Vec3 &a, const Vec3 &b, const Vec3 &t) { return a + (b - a) * t; }
+
+inline float clamp(float v, float lo, float hi) { return v < lo ? lo : (v > hi ? hi : v); }
+inline Vec3 clamp(const Vec3 &v, float lo, float hi) { return Vec3(clamp(v.x, lo, hi), clamp(v.y, lo, hi), clamp(v.z, lo, hi)); }
+
+inline Vec3 pow(const Vec3 &v, const Vec3 &e) { return Vec3(std::pow(v.x, e.x), std::pow(v.y, e.y), std::pow(v.z, e.z)); }
+
+// Rotation like the shader's rot2D, applied as `v *= rot2D(angle)`
+inline Vec2 rotate2D(const Vec2 &v, float angle) {
+    float s = std::sin(angle);
+    float c = std::cos(angle);
+
+    // GLSL's mat2(c, -s, s, c) is column major, a row vector times it
+    return Vec2(v.x * c - v.y * s, v.x * s + v.y * c);
+}
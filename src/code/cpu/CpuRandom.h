@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "CpuMath.h"
+
+// common/random.glsl in C++
+// Everything is done on uint32_t so the sequence is bit for bit the one the shaders make
+
+inline uint32_t wang_hash(uint32_t &seed) {
+    seed = (seed ^ 61u) ^ (seed >> 16);
+    seed *= 9u;
+    seed = seed ^ (seed >> 4);
+    seed *= 0x27d4eb2du;
+    seed = seed ^ (seed >> 15);
+    return seed;
+}
+
+inline float RandomFloat01(uint32_t &state) {
+    return float(wang_hash(state)) / 4294967296.0f;
+}
+
+inline Vec3 RandomUnitVector(uint32_t &state) {
+    float z = RandomFloat01(state) * 2.0f - 1.0f;
+    float a = RandomFloat01(state) * TWO_PI;
+    float r = std::sqrt(1.0f - z * z);
+    float x = r * std::cos(a);
+    float y = r * std::sin(a);
+    return Vec3(x, y, z);
+}
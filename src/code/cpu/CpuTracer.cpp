@@ -0,0 +1,465 @@
+#include "CpuTracer.h"
+
+#include "CpuRandom.h"
+#include "CpuBrdf.h"
+
+#include <fstream>
+#include <iostream>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Thread Count - how many threads render tiles, 0 for one per core
+CpuTracer::CpuTracer(int threadCount) : scheduler(threadCount) {
+
+    // Widest SIMD this CPU has
+    kernel = PacketKernels::best();
+}
+
+
+// ------------------------------- Setters --------------------------------------
+
+
+void CpuTracer::setScene(const SceneBlock &scene) {
+
+    this->scene = scene;
+
+    // Rebuild the SoA copy, the spheres keep their scene index so materials can be found again
+    sphereSoA.clear();
+
+    for (int i = 0; i < SCENE_SPHERE_NUM; i++) {
+        sphereSoA.add(scene.spheres[i], i);
+    }
+}
+
+
+// ----------------------- RAY-OBJECT EQUATIONS ---------------------------------
+
+
+CpuTracer::HitInfo CpuTracer::intersect(const Ray &ray, const Sphere &sphere) {
+    HitInfo hit;
+
+    hit.hit = false;
+
+    Vec3 position(sphere.position);
+    Vec3 rayOffset = ray.orgin - position;
+
+    float a = dot(ray.direction, ray.direction);
+    float b = dot(rayOffset, ray.direction);
+    float c = dot(rayOffset, rayOffset) - sphere.radius * sphere.radius;
+
+    float det = b * b - a * c;
+
+    if (det < 0.0f) { return hit; }
+
+    float t0 = (-b - std::sqrt(det)) / (a);
+
+    if (t0 < 0.0f) {
+
+        float t1 = (-b + std::sqrt(det)) / (a);
+
+        if (t1 < 0.0f) {
+            return hit;
+        }
+
+        hit.hit = true;
+        hit.hitPos = ray.orgin + ray.direction * t1;
+        hit.dist = t1;
+        hit.normal = normalize(hit.hitPos - position);
+        hit.material = &sphere.material;
+
+        return hit;
+    }
+
+    hit.hit = true;
+    hit.hitPos = ray.orgin + ray.direction * t0;
+    hit.dist = t0;
+    hit.normal = normalize(hit.hitPos - position);
+    hit.material = &sphere.material;
+
+    return hit;
+}
+
+// Calculate the closest object in the scene
+CpuTracer::HitInfo CpuTracer::calculateClosestHit(const Ray &ray) const {
+
+    // Start with a base hit info
+    HitInfo closestHit;
+    closestHit.hit = false;
+    closestHit.dist = 800000000000000000000.0f;
+
+    // Loop every sphere
+    for (int i = 0; i < SCENE_SPHERE_NUM; i++) {
+
+        HitInfo hit = intersect(ray, scene.spheres[i]);
+
+        // If the hit hit, and it is closer than the current closest
+        if (hit.hit && hit.dist < closestHit.dist) {
+            closestHit = hit;
+        }
+    }
+
+    return closestHit;
+}
+
+
+// ----------------------------- PBR FUNCTIONS ----------------------------------
+
+
+// rngState is a copy, same as the shader's (non inout) parameter
+Vec3 CpuTracer::PBR(Ray ray, uint32_t rngState) const {
+
+    HitInfo hit;
+
+    Vec3 hitMod = Vec3(1.0f);
+    Vec3 totalColor = Vec3(0.0f);
+
+    for (int i = 0; i <= MAX_BOUNCES; i++) {
+
+        hit = calculateClosestHit(ray);
+
+        if (!hit.hit) {
+            break;
+        }
+
+        const RayTracingMaterial &material = *hit.material;
+        Vec3 albedo(material.albedo);
+
+        Vec3 F0 = Vec3(0.04f);
+        F0 = mix(F0, pow(albedo, Vec3(2.2f)), material.metallic);
+
+        Vec3 V = normalize(ray.orgin - hit.hitPos);
+
+        Vec3 N = hit.normal;
+
+        float cosTheta = std::max(dot(hit.normal, V), 0.0f);
+
+
+        /* PBR Calculations */
+        // BDRF parts
+        float NDF = distributionGGX(N, N, material.roughness);
+        float G = geometrySmith(N, V, N, material.roughness);
+        Vec3 F = fresnelSchlick(cosTheta, F0);
+
+        // Now get the energy of the equation
+        Vec3 Kd = Vec3(1.0f) - F;
+        Kd *= 1.0f - material.metallic;
+
+        // Cook - Torrence
+        Vec3 numerator = NDF * G * F;
+        float denominator = 4.0f * std::max(dot(N, V), 0.0f) * cosTheta;
+
+        ray.orgin = hit.hitPos + hit.normal * 0.1f;
+
+        // Specular part
+        Vec3 specular = numerator / std::max(denominator, 0.0001f);
+
+        // calculate whether we are going to do a diffuse or specular reflection ray
+        float doSpecular = (RandomFloat01(rngState) < 0.5f) ? 1.0f : 0.0f;
+
+        Vec3 diffuseRayDir = normalize(hit.normal + RandomUnitVector(rngState));
+        if (dot(hit.normal, diffuseRayDir) >= 90.0f) { diffuseRayDir = -diffuseRayDir; }
+        Vec3 specularRayDir = specular;
+        specularRayDir = normalize(mix(specularRayDir, diffuseRayDir, material.roughness));
+        ray.direction = mix(diffuseRayDir, specularRayDir, doSpecular);
+
+        Vec3 diffuse = pow(albedo, Vec3(2.2f));
+
+        //Final lighting equation
+        hitMod *= Kd * diffuse;
+        totalColor += material.emmisive * hitMod;
+    }
+
+    return totalColor;
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// The camera ray through a pixel
+CpuTracer::Ray CpuTracer::primaryRay(const TraceSettings &settings, int x, int y) const {
+
+    // Pixel centers, like gl_FragCoord
+    Vec2 fragCoord((float)x + 0.5f, (float)y + 0.5f);
+    Vec2 resolution((float)settings.width, (float)settings.height);
+    Vec2 mouse(settings.mouseX, settings.mouseY);
+
+
+    /* Camera Setup */
+
+    // Calculate the uv coords and correct aspect ratio
+    Vec2 uv = (((fragCoord) / resolution) * 2.0f - 1.0f) * Vec2(resolution.x / resolution.y, 1.0f);
+    Vec2 m = (mouse * 2.0f - resolution) / resolution.y;
+
+    // Calculate the angle with the FOV
+    float angle = std::tan((PI * 0.5f * 30.0f) / 180.0f);
+    uv = uv * Vec2(angle, angle);
+
+
+    /* Ray */
+
+    Ray ray;
+    ray.orgin = Vec3(-5.0f, 0.0f, -10.0f);
+    ray.direction = normalize(Vec3(uv.x, uv.y, 1.0f));
+
+    // Apply mouse movement
+    float mouseModifier = 3.0f;
+
+    if (settings.mouseMove) {
+        Vec2 xz;
+
+        xz = rotate2D(Vec2(ray.orgin.x, ray.orgin.z), -m.x * mouseModifier);
+        ray.orgin.x = xz.x; ray.orgin.z = xz.y;
+        xz = rotate2D(Vec2(ray.direction.x, ray.direction.z), -m.x * mouseModifier);
+        ray.direction.x = xz.x; ray.direction.z = xz.y;
+
+        Vec2 yz;
+
+        yz = rotate2D(Vec2(ray.orgin.y, ray.orgin.z), m.y * mouseModifier);
+        ray.orgin.y = yz.x; ray.orgin.z = yz.y;
+        yz = rotate2D(Vec2(ray.direction.y, ray.direction.z), m.y * mouseModifier);
+        ray.direction.y = yz.x; ray.direction.z = yz.y;
+    }
+
+    return ray;
+}
+
+// The rest of main() once the first hit is known
+CpuTracer::Sample CpuTracer::shade(const TraceSettings &settings, int x, int y, const Ray &ray, const HitInfo &hit) const {
+
+    // If the ray doesn't hit
+    if (!hit.hit) {
+        return { Vec3(0.1647f, 0.1765f, 0.1765f), true };
+    }
+
+    // Same float math as the shader's int(gl_FragCoord.y * u_resolution.x + gl_FragCoord.x)
+    int pixelIndex = int(((float)y + 0.5f) * (float)settings.width + ((float)x + 0.5f));
+
+
+    /* PBR & Path Tracing */
+
+    Vec3 Lo = Vec3(0.0f);
+
+    for (int i = 0; i < SAMPLES; i++) {
+
+        // The shader's int math wraps, so it's done unsigned here to get the same bits
+        uint32_t rngState = ((uint32_t)pixelIndex * 3014u) * ((uint32_t)settings.time * 3u * (uint32_t)(i + 1) * 12u);
+
+        Lo += PBR(ray, rngState) / (float)SAMPLES;
+    }
+
+
+    // Post-Path procsessing
+    float ao = scene.ambient;
+    Vec3 ambient = Vec3(0.03f) * Vec3(hit.material->albedo) * ao;
+
+    Vec3 color = ambient + Lo;
+
+    // HDR and gamma correction are left to whoever averages the samples
+    return { color, false };
+}
+
+// main() for one pixel
+Vec3 CpuTracer::shadePixel(const TraceSettings &settings, int x, int y) const {
+
+    Ray ray = primaryRay(settings, x, y);
+
+    Sample sample = shade(settings, x, y, ray, calculateClosestHit(ray));
+
+    // Apply HDR and gamma correction
+    return sample.background ? sample.color : ReinhardGamma(sample.color);
+}
+
+// Rebuild a HitInfo from a packet's closest sphere
+CpuTracer::HitInfo CpuTracer::packetHit(const Ray &ray, const RayPacket &packet, int lane) const {
+
+    HitInfo hit;
+
+    // Missed everything
+    if (packet.sphere[lane] < 0) {
+        return hit;
+    }
+
+    const Sphere &sphere = scene.spheres[packet.sphere[lane]];
+
+    // Same as the end of intersect
+    hit.hit = true;
+    hit.dist = packet.dist[lane];
+    hit.hitPos = ray.orgin + ray.direction * hit.dist;
+    hit.normal = normalize(hit.hitPos - Vec3(sphere.position));
+    hit.material = &sphere.material;
+
+    return hit;
+}
+
+// A run of pixels along a row
+void CpuTracer::traceRun(const TraceSettings &settings, int x, int y, int count, Sample samples[PACKET_SIZE]) const {
+
+    Ray rays[PACKET_SIZE];
+    RayPacket packet;
+
+    for (int lane = 0; lane < count; lane++) {
+        rays[lane] = primaryRay(settings, x + lane, y);
+
+        packet.originX[lane] = rays[lane].orgin.x;
+        packet.originY[lane] = rays[lane].orgin.y;
+        packet.originZ[lane] = rays[lane].orgin.z;
+        packet.directionX[lane] = rays[lane].direction.x;
+        packet.directionY[lane] = rays[lane].direction.y;
+        packet.directionZ[lane] = rays[lane].direction.z;
+    }
+
+    packet.fill(count);
+
+    // First hits for the whole run at once
+    PacketKernels::closestHit(kernel, sphereSoA, packet);
+
+    // Bounces are still traced one ray at a time
+    for (int lane = 0; lane < count; lane++) {
+        samples[lane] = shade(settings, x + lane, y, rays[lane], packetHit(rays[lane], packet, lane));
+    }
+}
+
+// Where a tile is
+void CpuTracer::tileBounds(const TraceSettings &settings, int tile, int &startX, int &startY, int &endX, int &endY) const {
+
+    int tilesX = (settings.width + TILE_SIZE - 1) / TILE_SIZE;
+
+    startX = (tile % tilesX) * TILE_SIZE;
+    startY = (tile / tilesX) * TILE_SIZE;
+
+    endX = std::min(startX + TILE_SIZE, settings.width);
+    endY = std::min(startY + TILE_SIZE, settings.height);
+}
+
+// Whole frame
+void CpuTracer::render(const TraceSettings &settings, std::vector<float> &pixels) {
+
+    pixels.resize((size_t)settings.width * settings.height * 3);
+
+    int tilesX = (settings.width + TILE_SIZE - 1) / TILE_SIZE;
+    int tilesY = (settings.height + TILE_SIZE - 1) / TILE_SIZE;
+
+    // One task per tile
+    scheduler.runWave(tilesX * tilesY, [&](int tile) {
+
+        int startX, startY, endX, endY;
+        tileBounds(settings, tile, startX, startY, endX, endY);
+
+        Sample samples[PACKET_SIZE];
+
+        for (int y = startY; y < endY; y++) {
+            for (int x = startX; x < endX; x += PACKET_SIZE) {
+
+                int count = std::min(PACKET_SIZE, endX - x);
+                traceRun(settings, x, y, count, samples);
+
+                for (int lane = 0; lane < count; lane++) {
+
+                    // Apply HDR and gamma correction
+                    Vec3 color = samples[lane].background ? samples[lane].color : ReinhardGamma(samples[lane].color);
+
+                    float* pixel = &pixels[((size_t)y * settings.width + x + lane) * 3];
+                    pixel[0] = color.x;
+                    pixel[1] = color.y;
+                    pixel[2] = color.z;
+                }
+            }
+        }
+    });
+}
+
+// Many samples, shown as they come in
+void CpuTracer::renderProgressive(const TraceSettings &settings, int passes, DisplayBuffer &display) {
+
+    accumulation.assign((size_t)settings.width * settings.height * 4, 0.0f);
+
+    int tilesX = (settings.width + TILE_SIZE - 1) / TILE_SIZE;
+    int tilesY = (settings.height + TILE_SIZE - 1) / TILE_SIZE;
+
+    for (int pass = 0; pass < passes; pass++) {
+
+        // Each pass sees the next frame's u_time, so its seeds match the GPU's accumulation
+        TraceSettings passSettings = settings;
+        passSettings.time = settings.time + pass;
+
+        float weight = 1.0f / (float)(pass + 1);
+
+        // A new wave of tile tasks, tiles that hit the light take longer and get stolen around
+        scheduler.runWave(tilesX * tilesY, [&](int tile) {
+
+            int startX, startY, endX, endY;
+            tileBounds(passSettings, tile, startX, startY, endX, endY);
+
+            Sample samples[PACKET_SIZE];
+
+            for (int y = startY; y < endY; y++) {
+                for (int x = startX; x < endX; x += PACKET_SIZE) {
+
+                    int count = std::min(PACKET_SIZE, endX - x);
+                    traceRun(passSettings, x, y, count, samples);
+
+                    for (int lane = 0; lane < count; lane++) {
+
+                        float* pixel = &accumulation[((size_t)y * settings.width + x + lane) * 4];
+
+                        // Same blend as the shaders' accumulation
+                        Vec3 history(pixel[0], pixel[1], pixel[2]);
+                        Vec3 average = mix(history, samples[lane].color, weight);
+
+                        pixel[0] = average.x;
+                        pixel[1] = average.y;
+                        pixel[2] = average.z;
+                        pixel[3] = samples[lane].background ? 0.0f : 1.0f;
+
+                        // Same as the resolve pass, only traced pixels get tonemapped
+                        display.write(x + lane, y, samples[lane].background ? average : ReinhardGamma(average));
+                    }
+                }
+            }
+
+            // Readers can see this tile now
+            display.publishTile(tile, pass + 1);
+        });
+    }
+}
+
+// Write a PPM
+bool CpuTracer::savePPM(const std::string &path, int width, int height, const std::vector<float> &pixels) {
+
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file) {
+        std::cout << "Could not write the image to " << path << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    std::vector<unsigned char> row((size_t)width * 3);
+
+    // PPM's rows start at the top
+    for (int y = height - 1; y >= 0; y--) {
+
+        // Same rounding as a normalized 8 bit framebuffer
+        for (int i = 0; i < width * 3; i++) {
+            float value = pixels[(size_t)y * width * 3 + i];
+
+            // NaNs come out black on the GPU too
+            if (value != value) { value = 0.0f; }
+
+            row[i] = (unsigned char)(clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        file.write((const char*)row.data(), row.size());
+    }
+
+    return true;
+}
+
+// Stop the scheduler
+void CpuTracer::kill() {
+    scheduler.kill();
+}
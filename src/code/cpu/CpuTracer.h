@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../libs/SceneBlock.h"
+
+#include "CpuMath.h"
+#include "TileScheduler.h"
+#include "DisplayBuffer.h"
+#include "SpherePacket.h"
+
+// The uniforms fragment.frag reads, besides the scene block
+struct TraceSettings {
+    int width = 1200;
+    int height = 650;
+
+    int time = 0; // u_time, seeds the RNG
+
+    bool mouseMove = false; // u_mouseMove
+    float mouseX = 600.0f; // u_mousePosX
+    float mouseY = 325.0f; // u_mousePosY
+};
+
+// fragment.frag ported to C++ and run on the CPU
+// Uses the same RNG seeds as the shader so its images can be checked against the GPU's,
+// and it works as a fallback renderer on machines with no GPU
+class CpuTracer {
+
+    public:
+
+        // fragment.frag's defines
+        static const int MAX_BOUNCES = 1;
+        static const int SAMPLES = 3;
+
+    private:
+
+        // Ported structs (same names as the shader)
+        struct Ray {
+            Vec3 orgin;
+            Vec3 direction;
+        };
+
+        // What main() made for a pixel, linear unless it's the (display ready) background
+        struct Sample {
+            Vec3 color;
+            bool background;
+        };
+
+        struct HitInfo {
+            bool hit = false;
+            Vec3 hitPos;
+            float dist = 0.0f;
+            Vec3 normal;
+            const RayTracingMaterial* material = nullptr;
+        };
+
+        // The scene being drawn
+        SceneBlock scene;
+
+        // The scene's spheres for the packet kernels, and which kernel this CPU runs
+        SphereSoA sphereSoA;
+        PacketKernels::Kernel kernel;
+
+        // Tiles are rendered on this
+        TileScheduler scheduler;
+
+        // Running average of the progressive passes, RGB + 1 for traced / 0 for background like the GPU's
+        std::vector<float> accumulation;
+
+        // fragment.frag's functions
+        static HitInfo intersect(const Ray &ray, const Sphere &sphere);
+        HitInfo calculateClosestHit(const Ray &ray) const;
+        Vec3 PBR(Ray ray, uint32_t rngState) const;
+
+        // main() split in two so primary rays can be traced a packet at a time
+        Ray primaryRay(const TraceSettings &settings, int x, int y) const;
+        Sample shade(const TraceSettings &settings, int x, int y, const Ray &ray, const HitInfo &hit) const;
+
+        // Traces up to PACKET_SIZE pixels along a row, primary rays go through the packet kernel
+        void traceRun(const TraceSettings &settings, int x, int y, int count, Sample samples[PACKET_SIZE]) const;
+
+        // A tile's pixel bounds
+        void tileBounds(const TraceSettings &settings, int tile, int &startX, int &startY, int &endX, int &endY) const;
+
+        // Turns a packet lane back into the HitInfo intersect would have made
+        HitInfo packetHit(const Ray &ray, const RayPacket &packet, int lane) const;
+
+    public:
+
+        // Constructor
+        // Thread Count - 0 uses every core
+        CpuTracer(int threadCount);
+
+        // Setters
+        void setScene(const SceneBlock &scene);
+        void setKernel(PacketKernels::Kernel kernel) { this->kernel = kernel; }; // Defaults to PacketKernels::best()
+
+        // Getters
+        int getThreadCount() { return scheduler.getThreadCount(); };
+        int getStealCount() { return scheduler.getStealCount(); }; // Tiles taken from another thread's deque
+        PacketKernels::Kernel getKernel() { return kernel; };
+
+
+        // Methods
+
+        // The shader's main() for one pixel, (0, 0) is the bottom left like gl_FragCoord
+        // Returns the final display color
+        Vec3 shadePixel(const TraceSettings &settings, int x, int y) const;
+
+        // Renders a whole frame in tiles on the scheduler
+        // Pixels are RGB floats, rows bottom to top like glReadPixels
+        void render(const TraceSettings &settings, std::vector<float> &pixels);
+
+        // Renders passes samples per pixel, each pass is a wave of tile tasks using the next u_time (like the GPU accumulating)
+        // Tiles go to the display as they finish so it can be shown while this runs on another thread
+        void renderProgressive(const TraceSettings &settings, int passes, DisplayBuffer &display);
+
+        // Write RGB float pixels (rows bottom to top) as an 8 bit binary PPM, returns false on failure
+        static bool savePPM(const std::string &path, int width, int height, const std::vector<float> &pixels);
+
+        // Stops the threads
+        void kill();
+};
@@ -0,0 +1,116 @@
+#include "DisplayBuffer.h"
+
+#include <fstream>
+#include <iostream>
+#include <climits>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Width / Height - size of the frame, it's split into TILE_SIZE tiles the same way CpuTracer does
+DisplayBuffer::DisplayBuffer(int width, int height) {
+
+    this->width = width;
+    this->height = height;
+
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    pixels.reset(new std::atomic<uint32_t>[(size_t)width * height]);
+    tileSamples.reset(new std::atomic<int>[tilesX * tilesY]);
+
+    clear();
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Lowest pass count of any tile
+int DisplayBuffer::getMinSamples() {
+
+    int samples = INT_MAX;
+
+    for (int i = 0; i < tilesX * tilesY; i++) {
+        samples = std::min(samples, getTileSamples(i));
+    }
+
+    return samples;
+}
+
+// Pack and store a pixel
+void DisplayBuffer::write(int x, int y, const Vec3 &color) {
+
+    // Same rounding as a normalized 8 bit framebuffer, NaNs come out black
+    auto channel = [](float value) -> uint32_t {
+        if (value != value) { value = 0.0f; }
+        return (uint32_t)(clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+
+    uint32_t packed = channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16) | (255u << 24);
+
+    // Only this tile's thread writes here, the publish below orders it for readers
+    pixels[(size_t)y * width + x].store(packed, std::memory_order_relaxed);
+}
+
+// Make a tile's pixels visible
+void DisplayBuffer::publishTile(int tile, int samples) {
+    tileSamples[tile].store(samples, std::memory_order_release);
+}
+
+// Copy everything out
+void DisplayBuffer::read(std::vector<unsigned char> &rgb) {
+
+    rgb.resize((size_t)width * height * 3);
+
+    // Acquire every tile's pass count first (pairs with publishTile's release) so published tiles are complete
+    // Tiles that are mid pass can show a mix of that pass and the last, which is fine for a preview
+    for (int i = 0; i < tilesX * tilesY; i++) {
+        getTileSamples(i);
+    }
+
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+
+        uint32_t packed = pixels[i].load(std::memory_order_relaxed);
+
+        rgb[i * 3 + 0] = (unsigned char)(packed & 0xff);
+        rgb[i * 3 + 1] = (unsigned char)((packed >> 8) & 0xff);
+        rgb[i * 3 + 2] = (unsigned char)((packed >> 16) & 0xff);
+    }
+}
+
+// Write a PPM
+bool DisplayBuffer::savePPM(const std::string &path) {
+
+    std::vector<unsigned char> rgb;
+    read(rgb);
+
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file) {
+        std::cout << "Could not write the image to " << path << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    // PPM's rows start at the top
+    for (int y = height - 1; y >= 0; y--) {
+        file.write((const char*)&rgb[(size_t)y * width * 3], (size_t)width * 3);
+    }
+
+    return true;
+}
+
+// Back to nothing rendered
+void DisplayBuffer::clear() {
+
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        pixels[i].store(0xff000000u, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < tilesX * tilesY; i++) {
+        tileSamples[i].store(0, std::memory_order_release);
+    }
+}
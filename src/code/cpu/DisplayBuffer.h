@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "CpuMath.h"
+
+// Pixels per side of a render tile
+const int TILE_SIZE = 32;
+
+// 8 bit frame the render threads publish finished tiles into without locks
+// Another thread (a window, a progress printer) can read it at any time and sees every tile's latest pass
+class DisplayBuffer {
+
+    private:
+
+        int width;
+        int height;
+        int tilesX;
+        int tilesY;
+
+        // Packed RGBA8, rows bottom to top
+        std::unique_ptr<std::atomic<uint32_t>[]> pixels;
+
+        // Passes finished per tile, stored with release after the tile's pixels so readers see them complete
+        std::unique_ptr<std::atomic<int>[]> tileSamples;
+
+    public:
+
+        // Constructor
+        DisplayBuffer(int width, int height);
+
+        // Getters
+        int getWidth() { return width; };
+        int getHeight() { return height; };
+        int getTileCount() { return tilesX * tilesY; };
+        int getTileSamples(int tile) { return tileSamples[tile].load(std::memory_order_acquire); };
+        int getMinSamples(); // Passes every tile has finished
+
+
+        // Methods
+
+        // Set a display ready color (render threads, inside their own tile)
+        void write(int x, int y, const Vec3 &color);
+
+        // Mark a tile as finished with this many passes, makes its pixels visible to readers
+        void publishTile(int tile, int samples);
+
+        // Copy the frame out as RGB, rows bottom to top
+        void read(std::vector<unsigned char> &rgb);
+
+        // Save the frame as a binary PPM, returns false on failure
+        bool savePPM(const std::string &path);
+
+        // Forget every tile's passes
+        void clear();
+};
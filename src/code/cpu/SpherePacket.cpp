@@ -0,0 +1,154 @@
+#include "SpherePacket.h"
+
+#include <cmath>
+
+
+// ------------------------------- SphereSoA ------------------------------------
+
+
+void SphereSoA::add(const Sphere &sphere, int materialIndex) {
+    centerX.push_back(sphere.position[0]);
+    centerY.push_back(sphere.position[1]);
+    centerZ.push_back(sphere.position[2]);
+    radius.push_back(sphere.radius);
+    material.push_back(materialIndex);
+}
+
+void SphereSoA::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+    material.clear();
+}
+
+
+// ------------------------------- RayPacket ------------------------------------
+
+
+void RayPacket::fill(int count) {
+    for (int i = count; i < PACKET_SIZE; i++) {
+        originX[i] = originX[0];
+        originY[i] = originY[0];
+        originZ[i] = originZ[0];
+        directionX[i] = directionX[0];
+        directionY[i] = directionY[0];
+        directionZ[i] = directionZ[0];
+    }
+}
+
+
+// ------------------------------- Dispatch -------------------------------------
+
+
+const char* PacketKernels::name(Kernel kernel) {
+    switch (kernel) {
+        case SSE: return "SSE 4 wide";
+        case NEON: return "NEON 4 wide";
+        case AVX2: return "AVX2 8 wide";
+        default: return "Scalar";
+    }
+}
+
+bool PacketKernels::supported(Kernel kernel) {
+    switch (kernel) {
+
+        case SCALAR:
+            return true;
+
+        // SSE2 is part of x86-64
+        case SSE:
+#if defined(__SSE2__)
+            return true;
+#else
+            return false;
+#endif
+
+        // Only AArch64 has vector divide and sqrt
+        case NEON:
+#if defined(__aarch64__) && defined(__ARM_NEON)
+            return true;
+#else
+            return false;
+#endif
+
+        // Built in its own file with -mavx2, so the CPU has to be asked
+        case AVX2:
+#if defined(PACKET_AVX2)
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+PacketKernels::Kernel PacketKernels::best() {
+
+    if (supported(AVX2)) { return AVX2; }
+    if (supported(NEON)) { return NEON; }
+    if (supported(SSE)) { return SSE; }
+
+    return SCALAR;
+}
+
+void PacketKernels::closestHit(Kernel kernel, const SphereSoA &spheres, RayPacket &packet) {
+    switch (kernel) {
+        case SSE: closestHitSse(spheres, packet); break;
+        case NEON: closestHitNeon(spheres, packet); break;
+#if defined(PACKET_AVX2)
+        case AVX2: closestHitAvx2(spheres, packet); break;
+#endif
+        default: closestHitScalar(spheres, packet); break;
+    }
+}
+
+
+// ------------------------------- Scalar ---------------------------------------
+
+
+// The reference, one ray at a time exactly like the shader
+void PacketKernels::closestHitScalar(const SphereSoA &spheres, RayPacket &packet) {
+
+    for (int lane = 0; lane < PACKET_SIZE; lane++) {
+
+        float dx = packet.directionX[lane];
+        float dy = packet.directionY[lane];
+        float dz = packet.directionZ[lane];
+
+        float a = dx * dx + dy * dy + dz * dz;
+
+        float closest = PACKET_NO_HIT;
+        int closestSphere = -1;
+
+        for (int s = 0; s < spheres.size(); s++) {
+
+            float offsetX = packet.originX[lane] - spheres.centerX[s];
+            float offsetY = packet.originY[lane] - spheres.centerY[s];
+            float offsetZ = packet.originZ[lane] - spheres.centerZ[s];
+
+            float b = offsetX * dx + offsetY * dy + offsetZ * dz;
+            float c = (offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ) - spheres.radius[s] * spheres.radius[s];
+
+            float det = b * b - a * c;
+
+            if (det < 0.0f) { continue; }
+
+            // Near side, or the far side if we're inside
+            float t = (-b - std::sqrt(det)) / a;
+
+            if (t < 0.0f) {
+                t = (-b + std::sqrt(det)) / a;
+            }
+
+            if (!(t < 0.0f) && t < closest) {
+                closest = t;
+                closestSphere = s;
+            }
+        }
+
+        packet.dist[lane] = closest;
+        packet.sphere[lane] = closestSphere;
+    }
+}
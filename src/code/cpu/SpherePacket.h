@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+#include "../libs/SceneBlock.h"
+
+// Rays per packet, the AVX2 kernel does them all at once and the 4 wide ones do two halves
+const int PACKET_SIZE = 8;
+
+// What closestHit returns for lanes that hit nothing
+const float PACKET_NO_HIT = 800000000000000000000.0f;
+
+// Spheres split into one array per field so kernels stream through them
+struct SphereSoA {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+    std::vector<int> material; // Index into whatever material list the spheres came with
+
+    // Add a sphere
+    void add(const Sphere &sphere, int materialIndex);
+
+    // Remove every sphere
+    void clear();
+
+    int size() const { return (int)radius.size(); };
+};
+
+// Eight rays, SoA, aligned for 256 bit loads
+// Unused lanes should still hold a valid ray (fill() copies lane 0 into them)
+struct alignas(32) RayPacket {
+
+    // Rays in
+    float originX[PACKET_SIZE];
+    float originY[PACKET_SIZE];
+    float originZ[PACKET_SIZE];
+    float directionX[PACKET_SIZE];
+    float directionY[PACKET_SIZE];
+    float directionZ[PACKET_SIZE];
+
+    // Closest hit out, PACKET_NO_HIT / -1 on a miss
+    float dist[PACKET_SIZE];
+    int sphere[PACKET_SIZE];
+
+    // Copy lane 0 into lanes count and up
+    void fill(int count);
+};
+
+// Runtime picked kernels, same idea as GLExtensions
+// Every kernel gives exactly the scalar reference's result, which does fragment.frag's intersect + calculateClosestHit
+// in the same order (built with -ffp-contract=off, the GPU's own compiler is still free to fuse)
+namespace PacketKernels {
+
+    enum Kernel {
+        SCALAR,
+        SSE,
+        NEON,
+        AVX2
+    };
+
+    // Printable name
+    const char* name(Kernel kernel);
+
+    // True if the kernel was built in and this CPU can run it
+    bool supported(Kernel kernel);
+
+    // The widest supported kernel
+    Kernel best();
+
+    // Closest hit of every ray in the packet
+    void closestHit(Kernel kernel, const SphereSoA &spheres, RayPacket &packet);
+
+    // The kernels themselves (only call ones that are supported, the AVX2 one is only built on x86-64)
+    void closestHitScalar(const SphereSoA &spheres, RayPacket &packet);
+    void closestHitSse(const SphereSoA &spheres, RayPacket &packet);
+    void closestHitNeon(const SphereSoA &spheres, RayPacket &packet);
+    void closestHitAvx2(const SphereSoA &spheres, RayPacket &packet);
+}
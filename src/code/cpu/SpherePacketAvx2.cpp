@@ -0,0 +1,76 @@
+#include "SpherePacket.h"
+
+// Built with -mavx2 (and only that, FMA would change the results), only called when the CPU has it
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+// AVX2, all 8 rays at once
+void PacketKernels::closestHitAvx2(const SphereSoA &spheres, RayPacket &packet) {
+
+#if defined(__AVX2__)
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    __m256 originX = _mm256_load_ps(packet.originX);
+    __m256 originY = _mm256_load_ps(packet.originY);
+    __m256 originZ = _mm256_load_ps(packet.originZ);
+    __m256 dx = _mm256_load_ps(packet.directionX);
+    __m256 dy = _mm256_load_ps(packet.directionY);
+    __m256 dz = _mm256_load_ps(packet.directionZ);
+
+    // Same for every sphere
+    __m256 a = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+    __m256 closest = _mm256_set1_ps(PACKET_NO_HIT);
+    __m256i closestSphere = _mm256_set1_epi32(-1);
+
+    for (int s = 0; s < spheres.size(); s++) {
+
+        // One sphere against all 8 rays
+        __m256 offsetX = _mm256_sub_ps(originX, _mm256_set1_ps(spheres.centerX[s]));
+        __m256 offsetY = _mm256_sub_ps(originY, _mm256_set1_ps(spheres.centerY[s]));
+        __m256 offsetZ = _mm256_sub_ps(originZ, _mm256_set1_ps(spheres.centerZ[s]));
+        __m256 radius = _mm256_set1_ps(spheres.radius[s]);
+
+        __m256 b = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(offsetX, dx), _mm256_mul_ps(offsetY, dy)), _mm256_mul_ps(offsetZ, dz));
+        __m256 c = _mm256_sub_ps(
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(offsetX, offsetX), _mm256_mul_ps(offsetY, offsetY)), _mm256_mul_ps(offsetZ, offsetZ)),
+            _mm256_mul_ps(radius, radius)
+        );
+
+        __m256 det = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(a, c));
+
+        // Lanes that missed get NaNs here, the masks below throw them away
+        __m256 root = _mm256_sqrt_ps(det);
+        __m256 negativeB = _mm256_xor_ps(b, signBit);
+
+        __m256 t0 = _mm256_div_ps(_mm256_sub_ps(negativeB, root), a);
+        __m256 t1 = _mm256_div_ps(_mm256_add_ps(negativeB, root), a);
+
+        // Far side if the near side is behind us
+        __m256 t = _mm256_blendv_ps(t0, t1, _mm256_cmp_ps(t0, zero, _CMP_LT_OQ));
+
+        // Hit, in front, and closer than what we had
+        __m256 hit = _mm256_cmp_ps(det, zero, _CMP_NLT_UQ);
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, zero, _CMP_NLT_UQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(t, closest, _CMP_LT_OQ));
+
+        // Masked update
+        closest = _mm256_blendv_ps(closest, t, hit);
+        closestSphere = _mm256_castps_si256(_mm256_blendv_ps(
+            _mm256_castsi256_ps(closestSphere),
+            _mm256_castsi256_ps(_mm256_set1_epi32(s)),
+            hit
+        ));
+    }
+
+    _mm256_store_ps(packet.dist, closest);
+    _mm256_store_si256((__m256i*)packet.sphere, closestSphere);
+
+#else
+    closestHitScalar(spheres, packet);
+#endif
+}
@@ -0,0 +1,73 @@
+#include "SpherePacket.h"
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+
+// NEON, two passes of 4 rays
+void PacketKernels::closestHitNeon(const SphereSoA &spheres, RayPacket &packet) {
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+
+    for (int half = 0; half < PACKET_SIZE; half += 4) {
+
+        float32x4_t originX = vld1q_f32(&packet.originX[half]);
+        float32x4_t originY = vld1q_f32(&packet.originY[half]);
+        float32x4_t originZ = vld1q_f32(&packet.originZ[half]);
+        float32x4_t dx = vld1q_f32(&packet.directionX[half]);
+        float32x4_t dy = vld1q_f32(&packet.directionY[half]);
+        float32x4_t dz = vld1q_f32(&packet.directionZ[half]);
+
+        // Same for every sphere (separate multiply and add, vmla would fuse and change the bits)
+        float32x4_t a = vaddq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)), vmulq_f32(dz, dz));
+
+        float32x4_t closest = vdupq_n_f32(PACKET_NO_HIT);
+        int32x4_t closestSphere = vdupq_n_s32(-1);
+
+        for (int s = 0; s < spheres.size(); s++) {
+
+            // One sphere against all 4 rays
+            float32x4_t offsetX = vsubq_f32(originX, vdupq_n_f32(spheres.centerX[s]));
+            float32x4_t offsetY = vsubq_f32(originY, vdupq_n_f32(spheres.centerY[s]));
+            float32x4_t offsetZ = vsubq_f32(originZ, vdupq_n_f32(spheres.centerZ[s]));
+            float32x4_t radius = vdupq_n_f32(spheres.radius[s]);
+
+            float32x4_t b = vaddq_f32(vaddq_f32(vmulq_f32(offsetX, dx), vmulq_f32(offsetY, dy)), vmulq_f32(offsetZ, dz));
+            float32x4_t c = vsubq_f32(
+                vaddq_f32(vaddq_f32(vmulq_f32(offsetX, offsetX), vmulq_f32(offsetY, offsetY)), vmulq_f32(offsetZ, offsetZ)),
+                vmulq_f32(radius, radius)
+            );
+
+            float32x4_t det = vsubq_f32(vmulq_f32(b, b), vmulq_f32(a, c));
+
+            // Lanes that missed get NaNs here, the masks below throw them away
+            float32x4_t root = vsqrtq_f32(det);
+            float32x4_t negativeB = vnegq_f32(b);
+
+            float32x4_t t0 = vdivq_f32(vsubq_f32(negativeB, root), a);
+            float32x4_t t1 = vdivq_f32(vaddq_f32(negativeB, root), a);
+
+            // Far side if the near side is behind us
+            float32x4_t t = vbslq_f32(vcltq_f32(t0, zero), t1, t0);
+
+            // Hit (not less than zero, NaN counts), in front, and closer than what we had
+            uint32x4_t hit = vmvnq_u32(vcltq_f32(det, zero));
+            hit = vandq_u32(hit, vmvnq_u32(vcltq_f32(t, zero)));
+            hit = vandq_u32(hit, vcltq_f32(t, closest));
+
+            // Masked update
+            closest = vbslq_f32(hit, t, closest);
+            closestSphere = vbslq_s32(hit, vdupq_n_s32(s), closestSphere);
+        }
+
+        vst1q_f32(&packet.dist[half], closest);
+        vst1q_s32(&packet.sphere[half], closestSphere);
+    }
+
+#else
+    closestHitScalar(spheres, packet);
+#endif
+}
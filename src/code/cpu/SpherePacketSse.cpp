@@ -0,0 +1,77 @@
+#include "SpherePacket.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+// SSE2, two passes of 4 rays
+void PacketKernels::closestHitSse(const SphereSoA &spheres, RayPacket &packet) {
+
+#if defined(__SSE2__)
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    for (int half = 0; half < PACKET_SIZE; half += 4) {
+
+        __m128 originX = _mm_load_ps(&packet.originX[half]);
+        __m128 originY = _mm_load_ps(&packet.originY[half]);
+        __m128 originZ = _mm_load_ps(&packet.originZ[half]);
+        __m128 dx = _mm_load_ps(&packet.directionX[half]);
+        __m128 dy = _mm_load_ps(&packet.directionY[half]);
+        __m128 dz = _mm_load_ps(&packet.directionZ[half]);
+
+        // Same for every sphere
+        __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+        __m128 closest = _mm_set1_ps(PACKET_NO_HIT);
+        __m128i closestSphere = _mm_set1_epi32(-1);
+
+        for (int s = 0; s < spheres.size(); s++) {
+
+            // One sphere against all 4 rays
+            __m128 offsetX = _mm_sub_ps(originX, _mm_set1_ps(spheres.centerX[s]));
+            __m128 offsetY = _mm_sub_ps(originY, _mm_set1_ps(spheres.centerY[s]));
+            __m128 offsetZ = _mm_sub_ps(originZ, _mm_set1_ps(spheres.centerZ[s]));
+            __m128 radius = _mm_set1_ps(spheres.radius[s]);
+
+            __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(offsetX, dx), _mm_mul_ps(offsetY, dy)), _mm_mul_ps(offsetZ, dz));
+            __m128 c = _mm_sub_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetY, offsetY)), _mm_mul_ps(offsetZ, offsetZ)),
+                _mm_mul_ps(radius, radius)
+            );
+
+            __m128 det = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+
+            // Lanes that missed get NaNs here, the masks below throw them away
+            __m128 root = _mm_sqrt_ps(det);
+            __m128 negativeB = _mm_xor_ps(b, signBit);
+
+            __m128 t0 = _mm_div_ps(_mm_sub_ps(negativeB, root), a);
+            __m128 t1 = _mm_div_ps(_mm_add_ps(negativeB, root), a);
+
+            // Far side if the near side is behind us
+            __m128 behind = _mm_cmplt_ps(t0, zero);
+            __m128 t = _mm_or_ps(_mm_and_ps(behind, t1), _mm_andnot_ps(behind, t0));
+
+            // Hit, in front, and closer than what we had
+            __m128 hit = _mm_cmpnlt_ps(det, zero);
+            hit = _mm_and_ps(hit, _mm_cmpnlt_ps(t, zero));
+            hit = _mm_and_ps(hit, _mm_cmplt_ps(t, closest));
+
+            // Masked update
+            closest = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, closest));
+
+            __m128i hitInt = _mm_castps_si128(hit);
+            closestSphere = _mm_or_si128(_mm_and_si128(hitInt, _mm_set1_epi32(s)), _mm_andnot_si128(hitInt, closestSphere));
+        }
+
+        _mm_store_ps(&packet.dist[half], closest);
+        _mm_store_si128((__m128i*)&packet.sphere[half], closestSphere);
+    }
+
+#else
+    closestHitScalar(spheres, packet);
+#endif
+}
@@ -0,0 +1,155 @@
+#include "TileScheduler.h"
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Thread Count - how many workers, 0 for one per core
+TileScheduler::TileScheduler(int threadCount) {
+
+    if (threadCount <= 0) {
+        threadCount = (int)std::thread::hardware_concurrency();
+    }
+
+    // hardware_concurrency can't always tell
+    if (threadCount <= 0) {
+        threadCount = 1;
+    }
+
+    steals = 0;
+    running = true;
+
+    for (int i = 0; i < threadCount; i++) {
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+
+    for (int i = 0; i < threadCount; i++) {
+        workers.push_back(std::thread(&TileScheduler::work, this, i));
+    }
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Run a wave
+void TileScheduler::runWave(int taskCount, const std::function<void(int)> &task) {
+
+    int threadCount = (int)queues.size();
+
+    // Deal the tasks out in contiguous runs
+    for (int i = 0; i < threadCount; i++) {
+
+        int start = (int)((long long)taskCount * i / threadCount);
+        int end = (int)((long long)taskCount * (i + 1) / threadCount);
+
+        std::lock_guard<std::mutex> lock(queues[i]->mutex);
+
+        for (int t = start; t < end; t++) {
+            queues[i]->tasks.push_back(t);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Wake everyone up
+    this->task = task;
+    finishedWorkers = 0;
+    generation++;
+
+    wake.notify_all();
+
+    // Wait for every worker to run out of tasks to do or steal
+    done.wait(lock, [this] { return finishedWorkers == (int)workers.size(); });
+}
+
+// Our own newest task
+bool TileScheduler::pop(int self, int &task) {
+
+    Queue &queue = *queues[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.tasks.empty()) {
+        return false;
+    }
+
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+
+    return true;
+}
+
+// Someone else's oldest task, furthest from what they're working on
+bool TileScheduler::steal(int self, int &task) {
+
+    int threadCount = (int)queues.size();
+
+    // Start with the next thread so thieves spread out
+    for (int i = 1; i < threadCount; i++) {
+
+        Queue &queue = *queues[(self + i) % threadCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+
+            steals++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// A worker's loop
+void TileScheduler::work(int self) {
+
+    int seenGeneration = 0;
+
+    while (true) {
+
+        // Wait for a new wave
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return !running || generation != seenGeneration; });
+
+            if (!running) {
+                return;
+            }
+
+            seenGeneration = generation;
+        }
+
+        // Tasks don't make more tasks, so once every deque is empty this wave is done for us
+        int next;
+        while (pop(self, next) || steal(self, next)) {
+            task(next);
+        }
+
+        // Tell runWave we're done
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishedWorkers++;
+        }
+        done.notify_one();
+    }
+}
+
+// Stop every worker
+void TileScheduler::kill() {
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+
+    for (std::thread &worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    workers.clear();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <deque>
+
+// Work stealing scheduler for tile jobs
+// Every thread gets its own deque of tasks, it works from the back of its own and steals from the
+// front of the others' when it runs out, so threads stuck on slow tiles get helped out
+class TileScheduler {
+
+    private:
+
+        // One thread's tasks
+        struct Queue {
+            std::mutex mutex;
+            std::deque<int> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> workers;
+
+        // The wave being run
+        std::function<void(int)> task;
+
+        // Tasks run by a thread they weren't queued on
+        std::atomic<int> steals;
+
+        // Bumped for every wave so sleeping workers know there's a new one
+        int generation = 0;
+        int finishedWorkers = 0;
+        bool running = false;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+
+        // Take from the back of our own deque
+        bool pop(int self, int &task);
+
+        // Take from the front of someone else's
+        bool steal(int self, int &task);
+
+        // A worker's loop
+        void work(int self);
+
+    public:
+
+        // Constructor
+        // Thread Count - 0 uses every core
+        TileScheduler(int threadCount);
+
+        // Runs task(0) ... task(taskCount - 1) as one wave, returns when they're all done
+        // Each thread starts with a contiguous run of tasks so neighbouring tiles stay together
+        void runWave(int taskCount, const std::function<void(int)> &task);
+
+        // Getters
+        int getThreadCount() { return (int)workers.size(); };
+        int getStealCount() { return steals.load(); }; // Over every wave so far
+
+        // Stops the workers
+        void kill();
+
+        ~TileScheduler() { kill(); };
+};
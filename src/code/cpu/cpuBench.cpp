@@ -0,0 +1,107 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cmath>
+
+#include "SpherePacket.h"
+
+using namespace std;
+
+// Sphere packet kernel throughput
+// Usage: cpu_bench [spheres] [packets]
+// Every supported kernel traces the same packets, results are checked against the scalar one
+int main(int argc, char** argv) {
+
+    int sphereCount = argc > 1 ? atoi(argv[1]) : 64;
+    int packetCount = argc > 2 ? atoi(argv[2]) : 20000;
+
+    mt19937 random(1234);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    // The default scene's spheres plus random ones in front of the camera
+    SphereSoA spheres;
+    SceneBlock scene = createDefaultScene();
+
+    for (int i = 0; i < SCENE_SPHERE_NUM; i++) {
+        spheres.add(scene.spheres[i], i);
+    }
+
+    for (int i = spheres.size(); i < sphereCount; i++) {
+        Sphere sphere = {};
+        sphere.position[0] = unit(random) * 20.0f;
+        sphere.position[1] = unit(random) * 10.0f;
+        sphere.position[2] = 10.0f + unit(random) * 10.0f;
+        sphere.radius = 0.5f + fabs(unit(random)) * 2.0f;
+        spheres.add(sphere, i);
+    }
+
+    // Camera rays in random directions
+    vector<RayPacket> packets(packetCount);
+
+    for (RayPacket &packet : packets) {
+        for (int lane = 0; lane < PACKET_SIZE; lane++) {
+            float x = unit(random) * 0.5f;
+            float y = unit(random) * 0.3f;
+            float length = sqrt(x * x + y * y + 1.0f);
+
+            packet.originX[lane] = -5.0f;
+            packet.originY[lane] = 0.0f;
+            packet.originZ[lane] = -10.0f;
+            packet.directionX[lane] = x / length;
+            packet.directionY[lane] = y / length;
+            packet.directionZ[lane] = 1.0f / length;
+        }
+    }
+
+    // Scalar answers to check the others with
+    vector<RayPacket> reference = packets;
+    for (RayPacket &packet : reference) {
+        PacketKernels::closestHitScalar(spheres, packet);
+    }
+
+    cout << sphereCount << " spheres, " << packetCount * PACKET_SIZE << " rays" << endl;
+
+    PacketKernels::Kernel kernels[] = { PacketKernels::SCALAR, PacketKernels::SSE, PacketKernels::NEON, PacketKernels::AVX2 };
+
+    for (PacketKernels::Kernel kernel : kernels) {
+
+        if (!PacketKernels::supported(kernel)) {
+            continue;
+        }
+
+        // Best of a few runs
+        float bestMs = 1e30f;
+
+        for (int run = 0; run < 5; run++) {
+
+            auto start = chrono::steady_clock::now();
+
+            for (RayPacket &packet : packets) {
+                PacketKernels::closestHit(kernel, spheres, packet);
+            }
+
+            bestMs = min(bestMs, chrono::duration<float, milli>(chrono::steady_clock::now() - start).count());
+        }
+
+        // Every lane has to match the scalar kernel exactly
+        int mismatches = 0;
+
+        for (int i = 0; i < packetCount; i++) {
+            for (int lane = 0; lane < PACKET_SIZE; lane++) {
+                if (packets[i].sphere[lane] != reference[i].sphere[lane] || packets[i].dist[lane] != reference[i].dist[lane]) {
+                    mismatches++;
+                }
+            }
+        }
+
+        float mrays = (packetCount * PACKET_SIZE) / (bestMs * 1000.0f);
+
+        cout << PacketKernels::name(kernel) << ": " << mrays << " Mrays/s, " << mismatches << " mismatches" << endl;
+    }
+
+    cout << "Picked at runtime: " << PacketKernels::name(PacketKernels::best()) << endl;
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+
+#include "CpuTracer.h"
+
+using namespace std;
+
+// Renders fragment.frag's default scene on the CPU
+// Usage: cpu_render [output.ppm] [time] [width] [height] [threads] [passes]
+// Time is u_time, the same value gives the same RNG seeds as the GPU frame drawn with it
+// With more than one pass it averages them like the app's accumulation (pass n uses time + n)
+int main(int argc, char** argv) {
+
+    string output = argc > 1 ? argv[1] : "reference.ppm";
+
+    TraceSettings settings;
+    settings.time = argc > 2 ? atoi(argv[2]) : 0;
+    settings.width = argc > 3 ? atoi(argv[3]) : settings.width;
+    settings.height = argc > 4 ? atoi(argv[4]) : settings.height;
+
+    int threads = argc > 5 ? atoi(argv[5]) : 0;
+    int passes = argc > 6 ? atoi(argv[6]) : 1;
+
+    // Same scene the app starts with
+    CpuTracer tracer(threads);
+    tracer.setScene(createDefaultScene());
+
+    auto start = chrono::steady_clock::now();
+
+    bool saved;
+
+    // One pass straight to float pixels
+    if (passes <= 1) {
+
+        vector<float> pixels;
+        tracer.render(settings, pixels);
+
+        saved = CpuTracer::savePPM(output, settings.width, settings.height, pixels);
+    }
+
+    // Progressive, the passes run on another thread while this one watches the display buffer fill in
+    else {
+
+        DisplayBuffer display(settings.width, settings.height);
+        atomic<bool> finished(false);
+
+        thread renderer([&] {
+            tracer.renderProgressive(settings, passes, display);
+            finished = true;
+        });
+
+        while (!finished) {
+            this_thread::sleep_for(chrono::milliseconds(500));
+            cout << "Pass " << display.getMinSamples() << " / " << passes << " done" << endl;
+        }
+
+        renderer.join();
+
+        saved = display.savePPM(output);
+    }
+
+    float ms = chrono::duration<float, milli>(chrono::steady_clock::now() - start).count();
+
+    cout << "Rendered " << settings.width << "x" << settings.height << " x " << passes << " passes on " << tracer.getThreadCount()
+         << " threads in " << ms << " ms (" << tracer.getStealCount() << " tiles stolen)" << endl;
+
+    tracer.kill();
+
+    return saved ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include "Accumulator.h"
+
+#include <cstddef>
+#include <iostream>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Width / Height - size of the accumulation targets
+Accumulator::Accumulator(int width, int height) {
+
+    this->width = width;
+    this->height = height;
+
+    createTargets();
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Make both float targets
+void Accumulator::createTargets() {
+
+    glGenTextures(2, textures);
+    glGenFramebuffers(2, framebuffers);
+
+    for (int i = 0; i < 2; i++) {
+
+        // Full float so thousands of samples can be averaged without banding
+        // Linear so the resolve pass can scale a smaller render up (history reads use texelFetch)
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        // Attach it to its framebuffer
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[i], 0);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "Accumulation framebuffer is incomplete" << std::endl;
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    current = 0;
+    sampleCount = 0;
+
+    renderWidth = width;
+    renderHeight = height;
+}
+
+// Free both targets
+void Accumulator::deleteTargets() {
+    glDeleteFramebuffers(2, framebuffers);
+    glDeleteTextures(2, textures);
+}
+
+// Start writing a sample
+void Accumulator::begin() {
+
+    // Remember the window's viewport and framebuffer (headless windows draw into their own)
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    // Write into the current target
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[current]);
+    glViewport(0, 0, renderWidth, renderHeight);
+
+    // Read the other one as history
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures[1 - current]);
+}
+
+// Done writing a sample
+void Accumulator::end() {
+
+    // Back to the window
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+
+    // What we just wrote is the history next time
+    current = 1 - current;
+    sampleCount++;
+}
+
+// Forget the history, the next sample ignores it because its weight is 1 / (0 + 1)
+void Accumulator::reset() {
+    sampleCount = 0;
+}
+
+// Render into part of the targets
+void Accumulator::setRenderSize(int renderWidth, int renderHeight) {
+
+    // The history doesn't line up anymore
+    if (renderWidth != this->renderWidth || renderHeight != this->renderHeight) {
+        reset();
+    }
+
+    this->renderWidth = renderWidth;
+    this->renderHeight = renderHeight;
+}
+
+// New size
+void Accumulator::resize(int width, int height) {
+
+    // Nothing to do
+    if (width == this->width && height == this->height) {
+        return;
+    }
+
+    this->width = width;
+    this->height = height;
+
+    deleteTargets();
+    createTargets();
+}
+
+// Memory freeage
+void Accumulator::kill() {
+    deleteTargets();
+}
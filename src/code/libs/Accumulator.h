@@ -0,0 +1,85 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+class Accumulator {
+
+    private:
+
+        // Two RGBA32F targets, one is read as history while the other is written
+        GLuint textures[2];
+        GLuint framebuffers[2];
+
+        // Which one gets written next
+        int current = 0;
+
+        // Size of the targets
+        int width;
+        int height;
+
+        // The corner of the targets that gets rendered into (smaller with dynamic resolution)
+        int renderWidth;
+        int renderHeight;
+
+        // Samples in the history so far
+        int sampleCount = 0;
+
+        // Stop tracing once this many samples are in
+        int maxSamples = 4096;
+
+        // The viewport and framebuffer to go back to after a sample
+        GLint previousViewport[4];
+        GLint previousFramebuffer = 0;
+
+        // Make the targets
+        void createTargets();
+
+        // Free the targets
+        void deleteTargets();
+
+    public:
+
+        // Constructor
+        // Makes the two targets at the given size
+        Accumulator(int width, int height);
+
+        // Setters
+        void setMaxSamples(int maxSamples) { this->maxSamples = maxSamples; };
+        void setRenderSize(int renderWidth, int renderHeight); // Resets if it changed
+
+        // Getters
+        int getSampleCount() { return sampleCount; };
+        int getWidth() { return width; };
+        int getHeight() { return height; };
+        int getRenderWidth() { return renderWidth; };
+        int getRenderHeight() { return renderHeight; };
+
+        // Returns true once maxSamples is reached, there's no point tracing more
+        bool isConverged() { return sampleCount >= maxSamples; };
+
+        // The texture the last sample was written to
+        GLuint getResult() { return textures[1 - current]; };
+
+        // The framebuffer of that texture (for reading it back)
+        GLuint getResultFramebuffer() { return framebuffers[1 - current]; };
+
+
+        // Methods
+
+        // Start a sample, binds the write target and puts the history on texture unit 0
+        void begin();
+
+        // Finish a sample, swaps the targets and goes back to the window's framebuffer
+        void end();
+
+        // Throw the history away (camera / material / program changed)
+        void reset();
+
+        // Change size, also resets
+        void resize(int width, int height);
+
+        // Frees the targets
+        void kill();
+
+        Accumulator() {};
+};
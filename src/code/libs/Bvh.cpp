@@ -0,0 +1,273 @@
+#include "Bvh.h"
+
+#include <algorithm>
+#include <cfloat>
+
+
+// Bins per axis when looking for a split
+const int BVH_BINS = 12;
+
+// Leaves always get split above this, and never below MIN
+const int BVH_MAX_LEAF = 8;
+const int BVH_MIN_LEAF = 2;
+
+// Nodes this deep are always leaves, however many primitives they hold
+// The traversal keeps at most one node per level above the leaf, so the stack always has room (no need to walk the tree to check)
+const int BVH_MAX_DEPTH = 30;
+
+static_assert(BVH_MAX_DEPTH < BVH_STACK_SIZE, "The shader's stack has to fit the deepest path");
+
+
+// Half the surface area of a box (the factor of two cancels out in SAH)
+static float halfArea(const float min[3], const float max[3]) {
+
+    float x = max[0] - min[0];
+    float y = max[1] - min[1];
+    float z = max[2] - min[2];
+
+    return x * y + y * z + z * x;
+}
+
+static void growBounds(float min[3], float max[3], const float *pointMin, const float *pointMax) {
+    for (int i = 0; i < 3; i++) {
+        min[i] = std::min(min[i], pointMin[i]);
+        max[i] = std::max(max[i], pointMax[i]);
+    }
+}
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+Bvh::Bvh(const PrimitiveScene &scene) {
+
+    int count = (int)scene.primitives.size();
+
+    // Bounds and centroids of everything once
+    centroids.resize(count * 3);
+    boundsMin.resize(count * 3);
+    boundsMax.resize(count * 3);
+
+    for (int i = 0; i < count; i++) {
+
+        scene.getBounds(i, &boundsMin[i * 3], &boundsMax[i * 3]);
+
+        for (int axis = 0; axis < 3; axis++) {
+            centroids[i * 3 + axis] = (boundsMin[i * 3 + axis] + boundsMax[i * 3 + axis]) * 0.5f;
+        }
+
+        order.push_back(i);
+    }
+
+    // At most 2n - 1 nodes
+    nodes.reserve(std::max(1, count * 2 - 1));
+
+    // An empty scene still needs a root for the shader to read, -1 so it isn't taken for an inner node
+    if (count == 0) {
+        nodes.push_back({ {0.0f, 0.0f, 0.0f}, -1.0f, {0.0f, 0.0f, 0.0f}, 0.0f });
+    }
+
+    else {
+        buildNode(0, count, 0);
+    }
+
+    // Scratch isn't needed anymore
+    centroids.clear();
+    boundsMin.clear();
+    boundsMax.clear();
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+int Bvh::buildNode(int first, int count, int depth) {
+
+    int index = (int)nodes.size();
+    nodes.push_back(BvhNode());
+
+    // Bounds of everything in this node
+    float nodeMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float nodeMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    for (int i = first; i < first + count; i++) {
+        growBounds(nodeMin, nodeMax, &boundsMin[order[i] * 3], &boundsMax[order[i] * 3]);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        nodes[index].min[i] = nodeMin[i];
+        nodes[index].max[i] = nodeMax[i];
+    }
+
+    // Pick how to split, or make a leaf
+    int axis = 0;
+    float position = 0.0f;
+    bool split = count > BVH_MIN_LEAF && depth < BVH_MAX_DEPTH;
+    bool found = false;
+
+    if (split) {
+        found = findSplit(first, count, nodeMin, nodeMax, axis, position);
+        split = found || count > BVH_MAX_LEAF;
+    }
+
+    int leftCount = 0;
+
+    if (split && found) {
+
+        // Partition around the split
+        int* middle = std::partition(&order[first], &order[first] + count, [&](int primitive) {
+            return centroids[primitive * 3 + axis] < position;
+        });
+
+        leftCount = (int)(middle - &order[first]);
+    }
+
+    if (split) {
+
+        // Everything landed on one side (same centroids), or SAH found nothing but the node is too big, split at the median
+        if (leftCount == 0 || leftCount == count) {
+
+            // Longest axis of the node
+            axis = 0;
+            for (int i = 1; i < 3; i++) {
+                if (nodeMax[i] - nodeMin[i] > nodeMax[axis] - nodeMin[axis]) axis = i;
+            }
+
+            leftCount = count / 2;
+
+            std::nth_element(&order[first], &order[first] + leftCount, &order[first] + count, [&](int a, int b) {
+                return centroids[a * 3 + axis] < centroids[b * 3 + axis];
+            });
+        }
+    }
+
+    // Leaf
+    if (!split) {
+        nodes[index].leftOrFirst = (float)first;
+        nodes[index].count = (float)count;
+        return index;
+    }
+
+    // Left child lands right after us, the right one after the whole left subtree
+    buildNode(first, leftCount, depth + 1);
+    int right = buildNode(first + leftCount, count - leftCount, depth + 1);
+
+    nodes[index].leftOrFirst = (float)right;
+    nodes[index].count = 0.0f;
+
+    return index;
+}
+
+bool Bvh::findSplit(int first, int count, const float nodeMin[3], const float nodeMax[3], int &axis, float &position) {
+
+    float bestCost = FLT_MAX;
+
+    for (int a = 0; a < 3; a++) {
+
+        // Bin on the centroid bounds, not the node bounds
+        float centroidMin = FLT_MAX;
+        float centroidMax = -FLT_MAX;
+
+        for (int i = first; i < first + count; i++) {
+            centroidMin = std::min(centroidMin, centroids[order[i] * 3 + a]);
+            centroidMax = std::max(centroidMax, centroids[order[i] * 3 + a]);
+        }
+
+        // Nothing to split along this axis
+        if (centroidMax - centroidMin < 1e-6f) continue;
+
+        float binMin[BVH_BINS][3];
+        float binMax[BVH_BINS][3];
+        int binCount[BVH_BINS] = {};
+
+        for (int b = 0; b < BVH_BINS; b++) {
+            for (int i = 0; i < 3; i++) {
+                binMin[b][i] = FLT_MAX;
+                binMax[b][i] = -FLT_MAX;
+            }
+        }
+
+        float scale = BVH_BINS / (centroidMax - centroidMin);
+
+        for (int i = first; i < first + count; i++) {
+
+            int primitive = order[i];
+            int b = std::min(BVH_BINS - 1, (int)((centroids[primitive * 3 + a] - centroidMin) * scale));
+
+            binCount[b]++;
+            growBounds(binMin[b], binMax[b], &boundsMin[primitive * 3], &boundsMax[primitive * 3]);
+        }
+
+        // Sweep from the left, then the right, to cost every plane between bins
+        float leftArea[BVH_BINS - 1];
+        int leftCount[BVH_BINS - 1];
+
+        float sweepMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+        float sweepMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        int sweepCount = 0;
+
+        for (int b = 0; b < BVH_BINS - 1; b++) {
+            sweepCount += binCount[b];
+            if (binCount[b] > 0) growBounds(sweepMin, sweepMax, binMin[b], binMax[b]);
+
+            leftCount[b] = sweepCount;
+            leftArea[b] = sweepCount > 0 ? halfArea(sweepMin, sweepMax) : 0.0f;
+        }
+
+        for (int i = 0; i < 3; i++) {
+            sweepMin[i] = FLT_MAX;
+            sweepMax[i] = -FLT_MAX;
+        }
+        sweepCount = 0;
+
+        for (int b = BVH_BINS - 1; b > 0; b--) {
+            sweepCount += binCount[b];
+            if (binCount[b] > 0) growBounds(sweepMin, sweepMax, binMin[b], binMax[b]);
+
+            float rightArea = sweepCount > 0 ? halfArea(sweepMin, sweepMax) : 0.0f;
+            float cost = leftCount[b - 1] * leftArea[b - 1] + sweepCount * rightArea;
+
+            if (cost < bestCost) {
+                bestCost = cost;
+                axis = a;
+                position = centroidMin + b / scale;
+            }
+        }
+    }
+
+    // Compare with just intersecting everything (traversal costs about one primitive test)
+    float leafCost = count * halfArea(nodeMin, nodeMax);
+
+    return bestCost + halfArea(nodeMin, nodeMax) < leafCost;
+}
+
+int Bvh::getDepth() const {
+
+    // Nothing in it
+    if (nodes[0].leftOrFirst < 0.0f) {
+        return 0;
+    }
+
+    // Walk the tree with an explicit stack of (node, depth)
+    std::vector<std::pair<int, int>> stack;
+    stack.push_back({ 0, 1 });
+
+    int deepest = 0;
+
+    while (!stack.empty()) {
+
+        std::pair<int, int> entry = stack.back();
+        stack.pop_back();
+
+        deepest = std::max(deepest, entry.second);
+
+        const BvhNode &node = nodes[entry.first];
+
+        if (node.count == 0.0f) {
+            stack.push_back({ entry.first + 1, entry.second + 1 });
+            stack.push_back({ (int)node.leftOrFirst, entry.second + 1 });
+        }
+    }
+
+    return deepest;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include "./PrimitiveScene.h"
+
+// Nodes the shader's traversal can keep for later (match BVH_STACK_SIZE in common/bvh.glsl)
+const int BVH_STACK_SIZE = 32;
+
+// One node, 32 bytes so two RGBA32F texels hold it
+// Depth first layout: a node's left child is right after it, leftOrFirst is the right child
+// Leaves have count > 0 and leftOrFirst is their first primitive
+// An empty scene's root is the only node with count 0 and leftOrFirst -1
+struct BvhNode {
+    float min[3];
+    float leftOrFirst;
+    float max[3];
+    float count;
+};
+
+// Bounding volume hierarchy over a PrimitiveScene, built with binned SAH
+class Bvh {
+
+    private:
+
+        // Flattened tree, root at 0
+        std::vector<BvhNode> nodes;
+
+        // Primitive indices in leaf order
+        std::vector<int> order;
+
+        // Build scratch
+        std::vector<float> centroids;
+        std::vector<float> boundsMin;
+        std::vector<float> boundsMax;
+
+        // Builds the node for order[first, first + count), returns its index
+        int buildNode(int first, int count, int depth);
+
+        // Picks the split with binned SAH, returns false if a leaf is cheaper
+        bool findSplit(int first, int count, const float nodeMin[3], const float nodeMax[3], int &axis, float &position);
+
+    public:
+
+        // Constructor
+        // Builds the tree right away
+        Bvh(const PrimitiveScene &scene);
+
+        // Getters
+        const std::vector<BvhNode>& getNodes() const { return nodes; };
+        const std::vector<int>& getOrder() const { return order; };
+
+        // Deepest path through the tree, the shader's stack has to fit it (0 for an empty scene)
+        int getDepth() const;
+
+        Bvh() {};
+};
@@ -0,0 +1,123 @@
+#include "ConePrepass.h"
+
+#include <iostream>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+ConePrepass::ConePrepass(bool create) {
+
+    if (!create) return;
+
+    glGenTextures(1, &texture);
+    glGenFramebuffers(1, &framebuffer);
+
+    createTarget(1, 1);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+void ConePrepass::createTarget(int width, int height) {
+
+    this->width = width;
+    this->height = height;
+
+    // One distance per tile, read with texelFetch so no filtering
+    glActiveTexture(GL_TEXTURE0 + CONE_DEPTH_UNIT);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glActiveTexture(GL_TEXTURE0);
+
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Cone prepass framebuffer is incomplete" << std::endl;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+}
+
+void ConePrepass::setProgram(Program program) {
+    this->program = program;
+    hasProgram = program.isLinked();
+}
+
+void ConePrepass::fitTarget(int renderWidth, int renderHeight) {
+
+    // A tile for every started block of pixels
+    int tilesX = (renderWidth + CONE_TILE - 1) / CONE_TILE;
+    int tilesY = (renderHeight + CONE_TILE - 1) / CONE_TILE;
+
+    if (tilesX != width || tilesY != height) {
+        createTarget(tilesX, tilesY);
+    }
+}
+
+void ConePrepass::draw(WindowMesh* viewport, int renderWidth, int renderHeight) {
+
+    if (!hasProgram) {
+        clear(renderWidth, renderHeight);
+        return;
+    }
+
+    fitTarget(renderWidth, renderHeight);
+
+    GLint previousViewport[4];
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+
+    // The rays are worked out at full size, only the target is small
+    float renderSize[2] = { (float)renderWidth, (float)renderHeight };
+
+    program.use();
+    program.setArrayf2("u_renderSize", renderSize);
+    program.flushUniforms();
+
+    viewport->draw();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+}
+
+void ConePrepass::clear(int renderWidth, int renderHeight) {
+
+    fitTarget(renderWidth, renderHeight);
+
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    // Without touching the clear color the window uses
+    GLfloat zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glClearBufferfv(GL_COLOR, 0, zero);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+}
+
+void ConePrepass::bindSamplers(Program &program) {
+    program.bindSampler("u_coneDepth", CONE_DEPTH_UNIT, GL_TEXTURE_2D, texture);
+}
+
+void ConePrepass::kill() {
+
+    hasProgram = false;
+
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &texture);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+#include "./Program.h"
+#include "./WindowMesh.h"
+
+// Texture unit the full resolution pass reads the distances from (4 is the baked SDF)
+const GLuint CONE_DEPTH_UNIT = 5;
+
+// Pixels per side of a tile (match CONE_TILE in betterShader.frag)
+const int CONE_TILE = 8;
+
+// Low resolution depth prepass for the raymarchers
+// A program built with CONE_PREPASS marches one cone per tile into an R32F target,
+// programs built with CONE_START then start every ray of the tile from there
+class ConePrepass {
+
+    private:
+
+        GLuint texture = 0;
+        GLuint framebuffer = 0;
+
+        // Tiles across and down
+        int width = 0;
+        int height = 0;
+
+        // The program that marches the cones, owned by whoever built it (ProgramVariants)
+        Program program;
+        bool hasProgram = false;
+
+        // Make the target at a size
+        void createTarget(int width, int height);
+
+        // Resize the target to cover a render of this size
+        void fitTarget(int renderWidth, int renderHeight);
+
+    public:
+
+        // Constructor
+        // Makes a 1x1 target, draw resizes it (false leaves GL alone like the default constructor)
+        ConePrepass(bool create);
+
+        // Getters
+        Program& getProgram() { return program; }; // Set its uniforms like the main program's
+        bool isReady() { return hasProgram; };
+
+        // Setters
+        void setProgram(Program program); // Built with CONE_PREPASS
+        void clearProgram() { hasProgram = false; }; // It's stale or being rebuilt, nothing is drawn until the next one
+
+        // Methods
+        // Marches the cones for a render of this size, leaves the window's framebuffer and viewport as they were
+        // Without a program it clears instead, the rays march the whole way like without the prepass
+        void draw(WindowMesh* viewport, int renderWidth, int renderHeight);
+
+        // Fills the target with zeros for a render of this size, every ray starts at the camera
+        // For when there's no program (still building or failed) but something is drawn with CONE_START
+        void clear(int renderWidth, int renderHeight);
+
+        // Points the program's u_coneDepth at our unit
+        void bindSamplers(Program &program);
+
+        // Frees the target
+        void kill();
+
+        ConePrepass() {};
+};
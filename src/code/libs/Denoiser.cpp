@@ -0,0 +1,244 @@
+#include "Denoiser.h"
+
+#include <iostream>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Temporal Program - temporal.frag, blends each frame into the reprojected history
+// Filter Program - atrous.frag, one pass of the edge-avoiding blur
+// Width / Height - size of the targets
+Denoiser::Denoiser(Program temporalProgram, Program filterProgram, int width, int height) {
+
+    this->temporalProgram = temporalProgram;
+    this->filterProgram = filterProgram;
+
+    this->width = width;
+    this->height = height;
+
+    createTargets();
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// One of the targets, the passes read exact texels but the history is filtered when it's reprojected
+static GLuint createTexture(GLint format, GLenum type, int width, int height, GLint filter) {
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, GL_RGBA, type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    return texture;
+}
+
+// Attach textures to a framebuffer in order, and draw into all of them
+static void attachTextures(GLuint framebuffer, const GLuint* textures, int count) {
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    GLenum drawBuffers[4];
+
+    for (int i = 0; i < count; i++) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, textures[i], 0);
+        drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    }
+
+    glDrawBuffers(count, drawBuffers);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Denoiser framebuffer is incomplete" << std::endl;
+    }
+}
+
+// Make every target
+void Denoiser::createTargets() {
+
+    // Half floats are plenty for colors, depths are compared against each other so they get full floats
+    colorTexture = createTexture(GL_RGBA16F, GL_FLOAT, width, height, GL_NEAREST);
+    albedoTexture = createTexture(GL_RGBA8, GL_UNSIGNED_BYTE, width, height, GL_NEAREST);
+    motionTexture = createTexture(GL_RGBA32F, GL_FLOAT, width, height, GL_NEAREST);
+
+    for (int i = 0; i < 2; i++) {
+        normalDepthTextures[i] = createTexture(GL_RGBA32F, GL_FLOAT, width, height, GL_NEAREST);
+        historyTextures[i] = createTexture(GL_RGBA16F, GL_FLOAT, width, height, GL_LINEAR);
+
+        // Linear so the resolve pass can scale a smaller render up
+        filterTextures[i] = createTexture(GL_RGBA16F, GL_FLOAT, width, height, GL_LINEAR);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(2, gbufferFramebuffers);
+    glGenFramebuffers(2, historyFramebuffers);
+    glGenFramebuffers(2, filterFramebuffers);
+
+    for (int i = 0; i < 2; i++) {
+
+        // In the order of fragment.frag's outputs
+        GLuint gbuffer[4] = { colorTexture, normalDepthTextures[i], albedoTexture, motionTexture };
+        attachTextures(gbufferFramebuffers[i], gbuffer, 4);
+
+        // The history and the frame the filter starts from
+        GLuint history[2] = { historyTextures[i], filterTextures[1] };
+        attachTextures(historyFramebuffers[i], history, 2);
+
+        attachTextures(filterFramebuffers[i], &filterTextures[i], 1);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    current = 0;
+    result = 1;
+    historyValid = false;
+    settledFrames = 0;
+
+    renderWidth = width;
+    renderHeight = height;
+}
+
+// Free every target
+void Denoiser::deleteTargets() {
+
+    glDeleteFramebuffers(2, gbufferFramebuffers);
+    glDeleteFramebuffers(2, historyFramebuffers);
+    glDeleteFramebuffers(2, filterFramebuffers);
+
+    glDeleteTextures(1, &colorTexture);
+    glDeleteTextures(1, &albedoTexture);
+    glDeleteTextures(1, &motionTexture);
+    glDeleteTextures(2, normalDepthTextures);
+    glDeleteTextures(2, historyTextures);
+    glDeleteTextures(2, filterTextures);
+}
+
+void Denoiser::setTemporal(bool temporal) {
+    this->temporal = temporal;
+    reset();
+}
+
+bool Denoiser::isSettled() {
+
+    // Every frame stands on its own, there's nothing to wait for
+    if (!temporal) {
+        return true;
+    }
+
+    // A few times as long as the moving average reaches back
+    return settledFrames >= (int)(4.0f / minBlend);
+}
+
+// Start tracing a frame
+void Denoiser::begin(int renderWidth, int renderHeight) {
+
+    // The history doesn't line up anymore
+    if (renderWidth != this->renderWidth || renderHeight != this->renderHeight) {
+        reset();
+    }
+
+    this->renderWidth = renderWidth;
+    this->renderHeight = renderHeight;
+
+    // Remember the window's viewport and framebuffer (headless windows draw into their own)
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, gbufferFramebuffers[current]);
+    glViewport(0, 0, renderWidth, renderHeight);
+}
+
+// Done tracing
+void Denoiser::end() {
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+}
+
+// Temporal pass then the filter passes
+void Denoiser::filter(WindowMesh* viewport) {
+
+    glGetIntegerv(GL_VIEWPORT, previousViewport);
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+
+    glViewport(0, 0, renderWidth, renderHeight);
+
+    float renderSize[2] = { (float)renderWidth, (float)renderHeight };
+    int previous = 1 - current;
+
+    // Blend into the reprojected history
+    glBindFramebuffer(GL_FRAMEBUFFER, historyFramebuffers[current]);
+
+    temporalProgram.use();
+
+    temporalProgram.bindSampler("u_color", DENOISER_UNIT, GL_TEXTURE_2D, colorTexture);
+    temporalProgram.bindSampler("u_normalDepth", DENOISER_UNIT + 1, GL_TEXTURE_2D, normalDepthTextures[current]);
+    temporalProgram.bindSampler("u_motion", DENOISER_UNIT + 2, GL_TEXTURE_2D, motionTexture);
+    temporalProgram.bindSampler("u_previousNormalDepth", DENOISER_UNIT + 3, GL_TEXTURE_2D, normalDepthTextures[previous]);
+    temporalProgram.bindSampler("u_history", DENOISER_UNIT + 4, GL_TEXTURE_2D, historyTextures[previous]);
+
+    temporalProgram.setBool("u_historyValid", temporal && historyValid);
+    temporalProgram.setArrayf2("u_renderSize", renderSize);
+    temporalProgram.setFloat("u_minBlend", minBlend);
+    temporalProgram.setFloat("u_clampGamma", clampGamma);
+    temporalProgram.setBool("u_clampHistory", changed);
+    temporalProgram.flushUniforms();
+
+    viewport->draw();
+
+    // The blurs, each one twice as wide as the last
+    filterProgram.use();
+
+    filterProgram.setArrayf2("u_renderSize", renderSize);
+    filterProgram.setFloat("u_normalPhi", normalPhi);
+    filterProgram.setFloat("u_depthPhi", depthPhi);
+    filterProgram.setFloat("u_albedoPhi", albedoPhi);
+
+    filterProgram.bindSampler("u_normalDepth", DENOISER_UNIT + 1, GL_TEXTURE_2D, normalDepthTextures[current]);
+    filterProgram.bindSampler("u_albedo", DENOISER_UNIT + 2, GL_TEXTURE_2D, albedoTexture);
+
+    result = 1;
+
+    for (int i = 0; i < filterPasses; i++) {
+
+        glBindFramebuffer(GL_FRAMEBUFFER, filterFramebuffers[1 - result]);
+
+        filterProgram.bindSampler("u_color", DENOISER_UNIT, GL_TEXTURE_2D, filterTextures[result]);
+
+        filterProgram.setInt("u_stepSize", 1 << i);
+        filterProgram.setFloat("u_colorPhi", colorPhi / (float)(1 << i));
+        filterProgram.flushUniforms();
+
+        viewport->draw();
+
+        result = 1 - result;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+    glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+
+    // This frame is the history next time
+    current = previous;
+    historyValid = true;
+    settledFrames++;
+    changed = false;
+}
+
+// Forget the history
+void Denoiser::reset() {
+    historyValid = false;
+    settledFrames = 0;
+}
+
+// Memory freeage
+void Denoiser::kill() {
+    deleteTargets();
+    temporalProgram.kill();
+    filterProgram.kill();
+}
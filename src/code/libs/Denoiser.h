@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+#include "./Program.h"
+#include "./WindowMesh.h"
+
+// First of the texture units the passes read from (0 - 5 are the accumulation, BVH, baked SDF and cone prepass)
+const GLuint DENOISER_UNIT = 6;
+
+// Spatiotemporal denoiser for tracers that fill in a G-buffer (fragment.frag with u_denoise)
+// The tracer draws color, normal + depth, albedo and motion at once, temporal.frag blends that into the history
+// reprojected from last frame, then atrous.frag blurs it a few times without crossing edges in the G-buffer
+class Denoiser {
+
+    private:
+
+        // G-buffer, the normals and depths of last frame are kept to tell when the history belongs to another surface
+        GLuint colorTexture;
+        GLuint normalDepthTextures[2];
+        GLuint albedoTexture;
+        GLuint motionTexture;
+        GLuint gbufferFramebuffers[2];
+
+        // Temporal results, last frame's is read while this frame's is written
+        // Each one also writes its result with the display flag in alpha into filterTextures[1]
+        GLuint historyTextures[2];
+        GLuint historyFramebuffers[2];
+
+        // The filter passes go back and forth between these
+        GLuint filterTextures[2];
+        GLuint filterFramebuffers[2];
+
+        // The passes
+        Program temporalProgram;
+        Program filterProgram;
+
+        // Which side of the G-buffer and history pairs is written this frame
+        int current = 0;
+
+        // Where the finished frame is
+        int result = 1;
+
+        // Size of the targets
+        int width;
+        int height;
+
+        // The corner of the targets that gets rendered into (smaller with dynamic resolution)
+        int renderWidth;
+        int renderHeight;
+
+        // Last frame's history lines up with this frame
+        bool historyValid = false;
+
+        // Frames drawn since something changed
+        int settledFrames = 0;
+
+        // Something changed since the last frame, so the history gets clamped (a still frame's history is exact)
+        bool changed = false;
+
+        // Settings
+        bool temporal = true;
+        int filterPasses = 4;
+        float minBlend = 0.1f; // Weight of the newest frame once the history is long
+        float clampGamma = 1.5f; // Deviations around the neighbourhood the history is clamped to
+        float colorPhi = 4.0f; // Halved every pass, the larger steps have to stop at smaller color changes
+        float normalPhi = 64.0f;
+        float depthPhi = 0.1f;
+        float albedoPhi = 0.05f;
+
+        // The viewport and framebuffer to go back to
+        GLint previousViewport[4];
+        GLint previousFramebuffer = 0;
+
+        // Make the targets
+        void createTargets();
+
+        // Free the targets
+        void deleteTargets();
+
+    public:
+
+        // Constructor
+        // Takes the temporal.frag and atrous.frag programs and makes the targets at the given size
+        Denoiser(Program temporalProgram, Program filterProgram, int width, int height);
+
+        // Setters
+        void setTemporal(bool temporal); // Off shows every frame on its own, only filtered
+        void setFilterPasses(int filterPasses) { this->filterPasses = filterPasses; };
+        void setMinBlend(float minBlend) { this->minBlend = minBlend; };
+
+        // Getters
+        bool isTemporal() { return temporal; };
+        int getFilterPasses() { return filterPasses; };
+        float getMinBlend() { return minBlend; };
+        int getRenderWidth() { return renderWidth; };
+        int getRenderHeight() { return renderHeight; };
+
+        // The history is long enough that more frames barely change it
+        bool isSettled();
+
+        // The texture the finished frame is in, display ready pixels have alpha 0 like the accumulator's
+        GLuint getResult() { return filterTextures[result]; };
+
+        // The framebuffer of that texture (for reading it back)
+        GLuint getResultFramebuffer() { return filterFramebuffers[result]; };
+
+
+        // Methods
+
+        // Start the tracer's frame, binds this frame's G-buffer at the render size
+        void begin(int renderWidth, int renderHeight);
+
+        // Done tracing, goes back to the window's framebuffer
+        void end();
+
+        // Runs the temporal pass and the filter passes over the frame just traced
+        void filter(WindowMesh* viewport);
+
+        // Throw the history away (scene / program changed)
+        void reset();
+
+        // The camera or a uniform moved, the history is reprojected but has to settle again
+        void markChanged() { settledFrames = 0; changed = true; };
+
+        // Frees the targets and the programs
+        void kill();
+
+        Denoiser() {};
+};
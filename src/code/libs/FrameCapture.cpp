@@ -0,0 +1,267 @@
+#include "FrameCapture.h"
+#include "ImageWriter.h"
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+
+// The float targets flag display ready pixels (the background) with alpha 0, the rest is linear with alpha 1
+// Those are decoded with the display's gamma so the whole EXR is linear, and every pixel is written opaque
+static void linearizeDisplayReady(float* rgba, int count) {
+
+    for (int i = 0; i < count; i++) {
+
+        float* pixel = rgba + i * 4;
+
+        if (pixel[3] < 0.5f) {
+            for (int c = 0; c < 3; c++) {
+                pixel[c] = std::pow(std::max(pixel[c], 0.0f), 2.2f);
+            }
+        }
+
+        pixel[3] = 1.0f;
+    }
+}
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+FrameCapture::FrameCapture() {
+
+    for (int i = 0; i < RING_SIZE; i++) {
+        glGenBuffers(1, &slots[i].buffer);
+    }
+
+    // Start the encoder
+    running = true;
+    encoder = std::thread(&FrameCapture::run, this);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// What the window shows
+// Path - where the PNG goes
+void FrameCapture::captureWindow(const std::string &path) {
+
+    // The window's size is its viewport
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    read(path, CAPTURE_PNG, viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+// A float target
+// Path - where the EXR goes
+// Framebuffer - the target's framebuffer
+// Width / Height - how much of it to read, from the bottom left
+void FrameCapture::captureFloat(const std::string &path, GLuint framebuffer, int width, int height) {
+
+    GLint previous;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    read(path, CAPTURE_EXR, 0, 0, width, height);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previous);
+}
+
+// Start a read into the ring
+void FrameCapture::read(const std::string &path, Format format, int x, int y, int width, int height) {
+
+    Slot &slot = slots[next];
+
+    // The ring is full, only now do we wait on the oldest read
+    if (slot.inFlight) {
+        collect(slot, true);
+    }
+
+    GLsizeiptr size = (GLsizeiptr)width * height * (format == CAPTURE_PNG ? 4 : 16);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+
+    // Only grows, so a sequence at one size never reallocates
+    if (slot.capacity < size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+        slot.capacity = size;
+    }
+
+    // With a pack buffer bound this returns right away, the copy happens on the GPU
+    glReadPixels(x, y, width, height, GL_RGBA, format == CAPTURE_PNG ? GL_UNSIGNED_BYTE : GL_FLOAT, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Signaled once the copy is done
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.inFlight = true;
+
+    slot.path = path;
+    slot.format = format;
+    slot.width = width;
+    slot.height = height;
+
+    next = (next + 1) % RING_SIZE;
+    captured++;
+}
+
+// Copy a finished read out of its buffer and give it to the encoder
+// Wait - block until the GPU is done instead of giving up
+bool FrameCapture::collect(Slot &slot, bool wait) {
+
+    // Not waiting is the normal case, the read is a few frames old by now
+    GLbitfield flags = wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0;
+    GLuint64 timeout = wait ? 1000000000 : 0;
+
+    GLenum status = glClientWaitSync(slot.fence, flags, timeout);
+    bool done = status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+
+    // Look again next frame
+    if (!done && !wait) {
+        return false;
+    }
+
+    glDeleteSync(slot.fence);
+    slot.fence = 0;
+    slot.inFlight = false;
+
+    // Waited and it still didn't finish, the slot is needed so the frame is lost
+    if (!done) {
+        std::cout << "Frame capture timed out, " << slot.path << " was dropped" << std::endl;
+        return false;
+    }
+
+    Job job;
+    job.path = slot.path;
+    job.format = slot.format;
+    job.width = slot.width;
+    job.height = slot.height;
+    job.pixels.resize((size_t)slot.width * slot.height * (slot.format == CAPTURE_PNG ? 4 : 16));
+
+    // Copy it out so the buffer can be reused next frame
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, job.pixels.size(), GL_MAP_READ_BIT);
+
+    if (mapped != NULL) {
+        memcpy(job.pixels.data(), mapped, job.pixels.size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (mapped == NULL) {
+        std::cout << "Could not map the capture buffer, " << slot.path << " was dropped" << std::endl;
+        return false;
+    }
+
+    // Hand it over
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    wake.notify_one();
+
+    return true;
+}
+
+// Collect whatever is done
+void FrameCapture::update() {
+
+    // Oldest first so files are written in the order they were captured
+    for (int i = 0; i < RING_SIZE; i++) {
+
+        Slot &slot = slots[(next + i) % RING_SIZE];
+
+        if (slot.inFlight) {
+            collect(slot, false);
+        }
+    }
+}
+
+// Files finished
+int FrameCapture::getWrittenCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+// If anything is still on its way to disk
+bool FrameCapture::isBusy() {
+
+    for (int i = 0; i < RING_SIZE; i++) {
+        if (slots[i].inFlight) {
+            return true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return encoding || !jobs.empty();
+}
+
+// The encoder's loop
+void FrameCapture::run() {
+
+    while (true) {
+
+        Job job;
+
+        // Wait for work, and finish everything queued before stopping
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return !running || !jobs.empty(); });
+
+            if (jobs.empty()) {
+                break;
+            }
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            encoding = true;
+        }
+
+        // Encode and write (the slow part the run loop no longer waits on)
+        if (job.format == CAPTURE_PNG) {
+            writePng(job.path, job.width, job.height, (const uint8_t*)job.pixels.data());
+        }
+        else {
+            linearizeDisplayReady((float*)job.pixels.data(), job.width * job.height);
+            writeExr(job.path, job.width, job.height, (const float*)job.pixels.data());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            encoding = false;
+            written++;
+        }
+    }
+}
+
+// Finish up and clean up
+void FrameCapture::kill() {
+
+    // Reads still on the GPU, oldest first
+    for (int i = 0; i < RING_SIZE; i++) {
+
+        Slot &slot = slots[(next + i) % RING_SIZE];
+
+        if (slot.inFlight) {
+            collect(slot, true);
+        }
+    }
+
+    // Let the encoder drain its queue and stop
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_one();
+
+    if (encoder.joinable()) {
+        encoder.join();
+    }
+
+    for (int i = 0; i < RING_SIZE; i++) {
+        glDeleteBuffers(1, &slots[i].buffer);
+        slots[i].buffer = 0;
+        slots[i].capacity = 0;
+    }
+}
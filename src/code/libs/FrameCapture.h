@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+#include "../../includes/packs/standardImports.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+// Saves frames without stalling the run loop
+// glReadPixels goes into a ring of pixel pack buffers with a fence each, the buffers are mapped
+// a few frames later once the GPU is done, and a background thread encodes and writes the files
+class FrameCapture {
+
+    public:
+
+        // Pack buffers in flight, a capture every frame only waits if the GPU is this far behind
+        static const int RING_SIZE = 3;
+
+        // What a capture reads
+        enum Format {
+            CAPTURE_PNG, // RGBA8 from the window, written as PNG
+            CAPTURE_EXR  // RGBA32F from a float target, written as EXR
+        };
+
+    private:
+
+        // One pack buffer and the read that's in it
+        struct Slot {
+            GLuint buffer = 0;
+            GLsizeiptr capacity = 0;
+
+            GLsync fence = 0;
+            bool inFlight = false;
+
+            std::string path;
+            Format format = CAPTURE_PNG;
+            int width = 0;
+            int height = 0;
+        };
+
+        // A mapped frame waiting for the encoder
+        struct Job {
+            std::string path;
+            Format format;
+            int width;
+            int height;
+            std::vector<char> pixels;
+        };
+
+        Slot slots[RING_SIZE];
+
+        // Where the next read goes
+        int next = 0;
+
+        // Reads since the last reset, for the gui
+        int captured = 0;
+
+        // The encoder thread
+        std::thread encoder;
+
+        // Everything below is shared with the encoder
+        std::mutex mutex;
+        std::condition_variable wake;
+
+        std::deque<Job> jobs;
+        bool running = false;
+        bool encoding = false;
+        int written = 0;
+
+        // Start a read of the bound read framebuffer into the next slot
+        void read(const std::string &path, Format format, int x, int y, int width, int height);
+
+        // Copy a finished slot out and queue it, wait says if it may block on the fence
+        bool collect(Slot &slot, bool wait);
+
+        // The encoder's loop
+        void run();
+
+    public:
+
+        // Constructor
+        // Needs a current context (the buffers are made here)
+        FrameCapture();
+
+        // Queue a read of what the window's framebuffer shows now, saved as a PNG
+        // Call after drawing and before swapping
+        void captureWindow(const std::string &path);
+
+        // Queue a read of a float target (like the accumulator's), saved as an EXR
+        // Its display ready pixels (alpha 0) are decoded with gamma 2.2, so the file is all linear and opaque
+        void captureFloat(const std::string &path, GLuint framebuffer, int width, int height);
+
+        // Hands every read the GPU has finished to the encoder, call once a frame
+        void update();
+
+        // Getters
+        int getCapturedCount() { return captured; }; // Reads started
+        int getWrittenCount(); // Files written
+        bool isBusy(); // True while reads are in flight or files are being written
+
+        // Finishes everything in flight, stops the encoder and frees the buffers
+        void kill();
+};
@@ -0,0 +1,65 @@
+#include "GLExtensions.h"
+
+#include <cstddef>
+#include <cstring>
+
+
+// ------------------------------- Entry points ---------------------------------
+
+
+bool GLExtensions::programBinary = false;
+
+PFNGLGETPROGRAMBINARYPROC GLExtensions::glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC GLExtensions::glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC GLExtensions::glProgramParameteri = NULL;
+
+bool GLExtensions::parallelShaderCompile = false;
+
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC GLExtensions::glMaxShaderCompilerThreadsKHR = NULL;
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Look through the context's extension list
+bool GLExtensions::supported(const char* name) {
+
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+    for (GLint i = 0; i < count; i++) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+
+        if (extension != NULL && strcmp(extension, name) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Load every extension we know about
+void GLExtensions::load(GLADloadproc getProcAddress) {
+
+    // Program binaries
+    glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)getProcAddress("glGetProgramBinary");
+    glProgramBinary = (PFNGLPROGRAMBINARYPROC)getProcAddress("glProgramBinary");
+    glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)getProcAddress("glProgramParameteri");
+
+    // The driver also has to offer at least one binary format
+    GLint binaryFormats = 0;
+    if (glGetProgramBinary && glProgramBinary && glProgramParameteri) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+    }
+
+    programBinary = binaryFormats > 0;
+
+    // Parallel shader compile (the ARB version has the same entry point under another name)
+    if (supported("GL_KHR_parallel_shader_compile")) {
+        glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)getProcAddress("glMaxShaderCompilerThreadsKHR");
+    } else if (supported("GL_ARB_parallel_shader_compile")) {
+        glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)getProcAddress("glMaxShaderCompilerThreadsARB");
+    }
+
+    parallelShaderCompile = glMaxShaderCompilerThreadsKHR != NULL;
+}
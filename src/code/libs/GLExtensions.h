@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+// Entry points newer than the GL 3.3 core glad was generated for
+// They are loaded by hand once a context exists, check the flags before calling any of them
+
+// ARB_get_program_binary (core in 4.1)
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+// KHR_parallel_shader_compile
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+namespace GLExtensions {
+
+    // True when program binaries can be saved and loaded
+    extern bool programBinary;
+
+    extern PFNGLGETPROGRAMBINARYPROC glGetProgramBinary;
+    extern PFNGLPROGRAMBINARYPROC glProgramBinary;
+    extern PFNGLPROGRAMPARAMETERIPROC glProgramParameteri;
+
+    // True when the driver can compile shaders on its own threads
+    extern bool parallelShaderCompile;
+
+    extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR;
+
+    // Returns true if the current context lists the extension
+    bool supported(const char* name);
+
+    // Load everything, a context must be current
+    // Get Proc Address - the loader of whatever made the context (GLFW or EGL)
+    void load(GLADloadproc getProcAddress);
+}
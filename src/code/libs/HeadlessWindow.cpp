@@ -0,0 +1,350 @@
+#include "../../includes/packs/gui.h"
+
+#include "HeadlessWindow.h"
+#include "GLExtensions.h"
+
+#include <cstring>
+#include <fstream>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Width / Height - size of the frames
+// Frame Limit - how many frames windowOpen lets through, 0 for no limit
+// Imgui - if imgui frames are started and drawn (into the framebuffer like everything else)
+HeadlessWindow::HeadlessWindow(int width, int height, int frameLimit, bool imgui) {
+
+    this->width = width;
+    this->height = height;
+    this->frameLimit = frameLimit;
+    this->imgui = imgui;
+
+    // Park the mouse in the middle of the frame
+    cursorX = width / 2.0;
+    cursorY = height / 2.0;
+
+    // Same version as the recomended Window constructor
+    if (!createContext(3, 3)) {
+        return;
+    }
+
+    // Load open gl and imgui
+    init();
+
+    // Make the frames' target
+    createFramebuffer();
+}
+
+
+// ------------------------------- Setters --------------------------------------
+
+
+// Move the stand in mouse
+void HeadlessWindow::setCursorPos(double x, double y) {
+    cursorX = x;
+    cursorY = y;
+}
+
+// Mouse position
+void HeadlessWindow::getCursorPos(double* x, double* y) {
+    *x = cursorX;
+    *y = cursorY;
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Make the EGL display and context
+bool HeadlessWindow::createContext(int majorGlVersion, int minorGlVersion) {
+
+    // Prefer Mesa's surfaceless platform, it needs no X / Wayland / GBM device at all
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+    if (getPlatformDisplay != NULL && clientExtensions != NULL && strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+
+    // Otherwise whatever the default is
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+        cout << "Error initializing EGL" << endl;
+        return false;
+    } else {
+        cout << "Initialized EGL" << endl;
+    }
+
+    // Desktop open gl, not ES
+    eglBindAPI(EGL_OPENGL_API);
+
+    // Any color config that could back a pbuffer
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+        cout << "Error finding an EGL config" << endl;
+        return false;
+    }
+
+    // Same core profile a Window asks GLFW for
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, majorGlVersion,
+        EGL_CONTEXT_MINOR_VERSION, minorGlVersion,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+    if (context == EGL_NO_CONTEXT) {
+        cout << "Error creating the EGL context" << endl;
+        return false;
+    }
+
+    // Frames go into our own framebuffer so a surface is only made if the driver insists
+    const char* displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    surfaceless = displayExtensions != NULL && strstr(displayExtensions, "EGL_KHR_surfaceless_context");
+
+    if (!surfaceless) {
+        const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+    }
+
+    // Make our context current for open gl
+    if (!eglMakeCurrent(display, surface, surface, context)) {
+        cout << "Error making the EGL context current" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Loading open gl
+void HeadlessWindow::init() {
+
+    // Initialize open gl
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        cout << "Failed to initialize GLAD" << endl;
+        return;
+    } else {
+        cout << "OpenGl loaded successfully" << endl;
+    }
+
+    // Load the entry points glad doesn't cover
+    GLExtensions::load((GLADloadproc)eglGetProcAddress);
+
+    if (imgui) {
+        // Setup Dear ImGui context
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+
+        // No platform backend, so we tell it the display size ourselves
+        io.DisplaySize = ImVec2((float)width, (float)height);
+
+        // Batch jobs shouldn't leave an imgui.ini behind
+        io.IniFilename = NULL;
+
+        // Only the renderer backend
+        ImGui_ImplOpenGL3_Init();
+    }
+}
+
+// Make the framebuffer
+void HeadlessWindow::createFramebuffer() {
+
+    // 8 bit color like a normal window's back buffer
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        cout << "Headless framebuffer is incomplete" << endl;
+    }
+
+    // Everything draws into it from now on
+    glViewport(0, 0, width, height);
+}
+
+// Run until the limit
+bool HeadlessWindow::windowOpen() {
+    return context != EGL_NO_CONTEXT && (frameLimit == 0 || frameCount < frameLimit);
+}
+
+// Run when starting the run loop
+void HeadlessWindow::start() {
+
+    // Draw into our framebuffer (something might have bound another one)
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    // Clears the screen
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // If imgui is used
+    if (imgui) {
+
+        // No platform backend, a steady 60fps clock
+        ImGuiIO& io = ImGui::GetIO();
+        io.DisplaySize = ImVec2((float)width, (float)height);
+        io.DeltaTime = 1.0f / 60.0f;
+
+        // Create a new frame in open gl
+        ImGui_ImplOpenGL3_NewFrame();
+
+        // Create a new frame
+        ImGui::NewFrame();
+    }
+}
+
+// Draw imgui
+void HeadlessWindow::renderGui() {
+
+    // If im gui is used
+    if (imgui) {
+
+        // Render the draw data
+        ImGui::Render();
+
+        // Render the draw data in open gl
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+}
+
+// Run when finished with the run loop
+void HeadlessWindow::present() {
+
+    // Nothing to swap, just make sure the frame gets drawn
+    glFlush();
+
+    frameCount++;
+}
+
+// Read the framebuffer
+void HeadlessWindow::readPixels(vector<unsigned char> &pixels) {
+
+    pixels.resize((size_t)width * height * 3);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+}
+
+// Write the last frame out
+bool HeadlessWindow::saveFrame(const string &path) {
+
+    vector<unsigned char> pixels;
+    readPixels(pixels);
+
+    ofstream file(path, ios::binary);
+
+    if (!file) {
+        cout << "Could not write the frame to " << path << endl;
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    // Open gl's rows start at the bottom, PPM's at the top
+    for (int y = height - 1; y >= 0; y--) {
+        file.write((const char*)&pixels[(size_t)y * width * 3], (size_t)width * 3);
+    }
+
+    return true;
+}
+
+// A context on the same display that shares our objects
+void* HeadlessWindow::createSharedContext() {
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+
+    EGLContext shared = eglCreateContext(display, config, context, contextAttributes);
+
+    if (shared == EGL_NO_CONTEXT) {
+        return NULL;
+    }
+
+    SharedContext* result = new SharedContext{ shared, EGL_NO_SURFACE };
+
+    // Same as ours, only make a surface if the driver needs one
+    if (!surfaceless) {
+        const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        result->surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+    }
+
+    return result;
+}
+
+// Use a shared context on this thread
+void HeadlessWindow::makeContextCurrent(void* context) {
+
+    // Release whatever this thread has
+    if (context == NULL) {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        return;
+    }
+
+    SharedContext* shared = (SharedContext*)context;
+    eglMakeCurrent(display, shared->surface, shared->surface, shared->context);
+}
+
+// Free a shared context
+void HeadlessWindow::destroySharedContext(void* context) {
+
+    SharedContext* shared = (SharedContext*)context;
+
+    if (shared->surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, shared->surface);
+    }
+
+    eglDestroyContext(display, shared->context);
+
+    delete shared;
+}
+
+// Frees everything
+void HeadlessWindow::kill() {
+
+    // Imgui still needs the context to free its objects
+    if (imgui) {
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui::DestroyContext();
+    }
+
+    // Free the framebuffer
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+
+    // Let go of the context and free it
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if (surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+    }
+
+    eglDestroyContext(display, context);
+    context = EGL_NO_CONTEXT;
+
+    eglTerminate(display);
+}
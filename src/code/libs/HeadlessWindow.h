@@ -0,0 +1,109 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+#include "../../includes/packs/standardImports.h"
+
+#include <vector>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "./Window.h"
+
+using namespace std;
+
+// A Window with no display, rendering into a framebuffer object on an EGL context
+// Works with no GPU (Mesa llvmpipe) so shaders can run on render nodes, in CI or in batch jobs
+class HeadlessWindow : public Window {
+
+    private:
+
+        // A context for another thread, and its surface if the driver needs one
+        struct SharedContext {
+            EGLContext context;
+            EGLSurface surface;
+        };
+
+        // EGL objects
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLConfig config;
+        EGLContext context = EGL_NO_CONTEXT;
+
+        // Only used when the driver can't make a context current without a surface
+        EGLSurface surface = EGL_NO_SURFACE;
+        bool surfaceless = false;
+
+        // What frames are drawn into
+        GLuint framebuffer = 0;
+        GLuint colorBuffer = 0;
+
+        // Size of the frames
+        int width;
+        int height;
+
+        // How many frames to run before windowOpen returns false (0 is forever)
+        int frameLimit;
+        int frameCount = 0;
+
+        // Stand in mouse position, starts in the middle
+        double cursorX;
+        double cursorY;
+
+        // Makes the display and the context, returns false on failure
+        bool createContext(int majorGlVersion, int minorGlVersion);
+
+        // Makes the framebuffer frames are drawn into
+        void createFramebuffer();
+
+        // Loads open gl and imgui
+        void init();
+
+    public:
+
+        // Constructor
+        // Frame Limit - frames to render before windowOpen returns false (0 runs until kill)
+        HeadlessWindow(int width, int height, int frameLimit, bool imgui);
+
+        // Getters
+        GLuint getFramebuffer() { return framebuffer; }; // The framebuffer frames are drawn into
+        int getFrameCount() { return frameCount; }; // Frames finished so far
+        void getCursorPos(double* x, double* y) override;
+
+        // Setters
+        void setCursorPos(double x, double y); // There's no mouse so batch jobs can move it themselves
+
+
+        // Methods
+
+        // Returns true until the frame limit is reached
+        bool windowOpen() override;
+
+        // Binds the framebuffer and starts the frame
+        void start() override;
+
+        // Draws imgui's frame into the framebuffer
+        void renderGui() override;
+
+        // Finishes the frame
+        void present() override;
+
+        // Never sleeps, there are no events and the frame limit has to be reached
+        bool waitEvents(double /*timeout*/) override { return true; };
+        void wake() override {};
+
+        // Frees the framebuffer and the context
+        void kill() override;
+
+        // Reads the last frame back, rows bottom to top, RGB
+        void readPixels(vector<unsigned char> &pixels);
+
+        // Saves the last frame as a binary PPM, returns false if the file can't be written
+        bool saveFrame(const string &path);
+
+        // Shared contexts (for the background shader compiler)
+        void* createSharedContext() override;
+        void makeContextCurrent(void* context) override;
+        void destroySharedContext(void* context) override;
+
+        HeadlessWindow() {};
+};
@@ -0,0 +1,268 @@
+#include "ImageWriter.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+
+// ------------------------------ Helpers ---------------------------------------
+
+
+// Big endian, PNG's byte order
+static void putBigEndian(std::vector<uint8_t> &out, uint32_t value) {
+    out.push_back((uint8_t)(value >> 24));
+    out.push_back((uint8_t)(value >> 16));
+    out.push_back((uint8_t)(value >> 8));
+    out.push_back((uint8_t)value);
+}
+
+// Little endian, EXR's byte order
+static void putLittleEndian(std::vector<uint8_t> &out, const void* value, size_t size) {
+    // Every platform we build for is little endian already
+    const uint8_t* bytes = (const uint8_t*)value;
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+static void putInt(std::vector<uint8_t> &out, int32_t value) { putLittleEndian(out, &value, 4); }
+static void putFloat(std::vector<uint8_t> &out, float value) { putLittleEndian(out, &value, 4); }
+
+static void putString(std::vector<uint8_t> &out, const char* text) {
+    out.insert(out.end(), text, text + strlen(text) + 1);
+}
+
+// Open the file and write everything at once
+static bool writeFile(const std::string &path, const std::vector<uint8_t> &data) {
+
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file) {
+        std::cout << "Could not write the image " << path << std::endl;
+        return false;
+    }
+
+    file.write((const char*)data.data(), data.size());
+    return (bool)file;
+}
+
+
+// -------------------------------- PNG -----------------------------------------
+
+
+// CRC-32 over a chunk's type and data
+static uint32_t crc32(const uint8_t* data, size_t size) {
+
+    // Made the first time it's needed
+    static uint32_t table[256];
+    static bool tableReady = false;
+
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Adler-32 over the uncompressed data, zlib's checksum
+static uint32_t adler32(const uint8_t* data, size_t size) {
+
+    uint32_t a = 1;
+    uint32_t b = 0;
+
+    // Biggest run that can't overflow before the modulo
+    const size_t RUN = 5552;
+
+    while (size > 0) {
+        size_t run = size < RUN ? size : RUN;
+        size -= run;
+
+        for (size_t i = 0; i < run; i++) {
+            a += *data++;
+            b += a;
+        }
+
+        a %= 65521;
+        b %= 65521;
+    }
+
+    return (b << 16) | a;
+}
+
+// Length, type, data, CRC
+static void putChunk(std::vector<uint8_t> &out, const char type[4], const std::vector<uint8_t> &data) {
+
+    putBigEndian(out, (uint32_t)data.size());
+
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+
+    putBigEndian(out, crc32(&out[start], out.size() - start));
+}
+
+bool writePng(const std::string &path, int width, int height, const uint8_t* rgba) {
+
+    // Rows are a filter byte (0, none) and RGB, top row first
+    size_t rowSize = 1 + (size_t)width * 3;
+    std::vector<uint8_t> raw(rowSize * height);
+
+    for (int y = 0; y < height; y++) {
+
+        uint8_t* row = &raw[rowSize * y];
+        const uint8_t* source = rgba + (size_t)(height - 1 - y) * width * 4;
+
+        row[0] = 0;
+
+        for (int x = 0; x < width; x++) {
+            row[1 + x * 3 + 0] = source[x * 4 + 0];
+            row[1 + x * 3 + 1] = source[x * 4 + 1];
+            row[1 + x * 3 + 2] = source[x * 4 + 2];
+        }
+    }
+
+    // zlib stream of stored blocks (at most 65535 bytes each)
+    std::vector<uint8_t> compressed;
+    compressed.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+
+    compressed.push_back(0x78);
+    compressed.push_back(0x01);
+
+    size_t offset = 0;
+
+    do {
+        size_t length = raw.size() - offset;
+        if (length > 65535) { length = 65535; }
+
+        bool last = offset + length == raw.size();
+
+        compressed.push_back(last ? 1 : 0);
+        compressed.push_back((uint8_t)length);
+        compressed.push_back((uint8_t)(length >> 8));
+        compressed.push_back((uint8_t)~length);
+        compressed.push_back((uint8_t)(~length >> 8));
+
+        compressed.insert(compressed.end(), raw.begin() + offset, raw.begin() + offset + length);
+        offset += length;
+
+    } while (offset < raw.size());
+
+    putBigEndian(compressed, adler32(raw.data(), raw.size()));
+
+    // Header, 8 bit truecolor
+    std::vector<uint8_t> header;
+    putBigEndian(header, width);
+    putBigEndian(header, height);
+    header.push_back(8); // Bit depth
+    header.push_back(2); // RGB
+    header.push_back(0); // Deflate
+    header.push_back(0); // Adaptive filtering
+    header.push_back(0); // Not interlaced
+
+    std::vector<uint8_t> file = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.reserve(compressed.size() + 64);
+
+    putChunk(file, "IHDR", header);
+    putChunk(file, "IDAT", compressed);
+    putChunk(file, "IEND", std::vector<uint8_t>());
+
+    return writeFile(path, file);
+}
+
+
+// -------------------------------- EXR -----------------------------------------
+
+
+// Name, type, size, then the value
+static void putAttribute(std::vector<uint8_t> &out, const char* name, const char* type, const std::vector<uint8_t> &value) {
+    putString(out, name);
+    putString(out, type);
+    putInt(out, (int32_t)value.size());
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+bool writeExr(const std::string &path, int width, int height, const float* rgba) {
+
+    // Channels have to be listed (and stored) alphabetically, so each is an index into RGBA
+    const char* channelNames[4] = { "A", "B", "G", "R" };
+    const int channelOffsets[4] = { 3, 2, 1, 0 };
+
+    std::vector<uint8_t> file;
+
+    // Magic and version 2, single part scanlines
+    putInt(file, 20000630);
+    putInt(file, 2);
+
+    // Every channel is 32 bit float and full resolution
+    std::vector<uint8_t> channels;
+    for (int c = 0; c < 4; c++) {
+        putString(channels, channelNames[c]);
+        putInt(channels, 2); // FLOAT
+        channels.insert(channels.end(), { 0, 0, 0, 0 }); // pLinear and reserved
+        putInt(channels, 1); // x sampling
+        putInt(channels, 1); // y sampling
+    }
+    channels.push_back(0);
+
+    std::vector<uint8_t> window;
+    putInt(window, 0);
+    putInt(window, 0);
+    putInt(window, width - 1);
+    putInt(window, height - 1);
+
+    std::vector<uint8_t> aspect;
+    putFloat(aspect, 1.0f);
+
+    std::vector<uint8_t> center;
+    putFloat(center, 0.0f);
+    putFloat(center, 0.0f);
+
+    putAttribute(file, "channels", "chlist", channels);
+    putAttribute(file, "compression", "compression", { 0 }); // None
+    putAttribute(file, "dataWindow", "box2i", window);
+    putAttribute(file, "displayWindow", "box2i", window);
+    putAttribute(file, "lineOrder", "lineOrder", { 0 }); // Increasing y
+    putAttribute(file, "pixelAspectRatio", "float", aspect);
+    putAttribute(file, "screenWindowCenter", "v2f", center);
+    putAttribute(file, "screenWindowWidth", "float", aspect);
+    file.push_back(0);
+
+    // Offset table, one entry per scanline, then the scanlines themselves
+    int32_t lineSize = width * 4 * 4;
+    uint64_t lineOffset = file.size() + (uint64_t)height * 8;
+
+    for (int y = 0; y < height; y++) {
+        putLittleEndian(file, &lineOffset, 8);
+        lineOffset += 8 + lineSize;
+    }
+
+    file.reserve(lineOffset);
+
+    for (int y = 0; y < height; y++) {
+
+        putInt(file, y);
+        putInt(file, lineSize);
+
+        // EXR's y goes down, open gl's goes up
+        const float* source = rgba + (size_t)(height - 1 - y) * width * 4;
+
+        for (int c = 0; c < 4; c++) {
+            for (int x = 0; x < width; x++) {
+                putFloat(file, source[x * 4 + channelOffsets[c]]);
+            }
+        }
+    }
+
+    return writeFile(path, file);
+}
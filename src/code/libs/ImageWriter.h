@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Image files for frame captures, no GL so the capture thread can call them
+// Pixels come in open gl's order (bottom row first) and are flipped on the way out
+//
+// PNG is 8 bit RGB from RGBA bytes (the alpha is dropped), written with stored deflate blocks
+// so encoding is a copy and a checksum, not a compression
+// EXR is uncompressed 32 bit float RGBA scanlines, for linear HDR straight from the accumulator
+
+// Writes RGBA8 pixels as a PNG
+bool writePng(const std::string &path, int width, int height, const uint8_t* rgba);
+
+// Writes RGBA32F pixels as an OpenEXR
+bool writeExr(const std::string &path, int width, int height, const float* rgba);
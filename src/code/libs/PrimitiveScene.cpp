@@ -0,0 +1,102 @@
+#include "PrimitiveScene.h"
+
+#include <random>
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+int PrimitiveScene::addMaterial(const PrimitiveMaterial &material) {
+    materials.push_back(material);
+    return (int)materials.size() - 1;
+}
+
+void PrimitiveScene::addSphere(float x, float y, float z, float radius, int material) {
+    primitives.push_back({ PRIMITIVE_SPHERE, {x, y, z}, {radius, radius, radius}, material, false });
+}
+
+void PrimitiveScene::addBox(float x, float y, float z, float halfX, float halfY, float halfZ, int material, bool hiddenFromCamera) {
+    primitives.push_back({ PRIMITIVE_BOX, {x, y, z}, {halfX, halfY, halfZ}, material, hiddenFromCamera });
+}
+
+// Both types are center +- size
+void PrimitiveScene::getBounds(int primitive, float min[3], float max[3]) const {
+
+    const Primitive &p = primitives[primitive];
+
+    for (int i = 0; i < 3; i++) {
+        min[i] = p.center[i] - p.size[i];
+        max[i] = p.center[i] + p.size[i];
+    }
+}
+
+
+// -------------------------------- Scenes --------------------------------------
+
+
+PrimitiveScene createCornellBoxScene() {
+
+    PrimitiveScene scene;
+
+    // Row of green spheres getting rougher left to right
+    for (int i = 0; i < 5; i++) {
+        int material = scene.addMaterial({ {0.3f, 1.0f, 0.3f}, {0.3f, 1.0f, 0.3f}, {0.0f, 0.0f, 0.0f}, i * 0.25f, 1.0f });
+        scene.addSphere(-3.0f + i * 1.5f, 0.0f, -3.0f, 0.6f, material);
+    }
+
+    // Big spheres on the floor
+    int yellow = scene.addMaterial({ {1.0f, 0.9882f, 0.3647f}, {0.9f, 0.9f, 0.9f}, {0.0f, 0.0f, 0.0f}, 0.2f, 0.1f });
+    int pink = scene.addMaterial({ {0.97f, 0.45f, 0.94f}, {0.9f, 0.9f, 0.9f}, {0.0f, 0.0f, 0.0f}, 0.2f, 0.3f });
+    int blue = scene.addMaterial({ {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, 0.5f, 0.5f });
+
+    scene.addSphere(-2.5f, -2.7f, -3.0f, 1.1f, yellow);
+    scene.addSphere(0.0f, -2.7f, -3.0f, 1.1f, pink);
+    scene.addSphere(2.5f, -2.7f, -3.0f, 1.1f, blue);
+
+    // Walls
+    int red = scene.addMaterial({ {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 1.0f, 0.0f });
+    int white = scene.addMaterial({ {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 1.0f, 0.0f });
+    int green = scene.addMaterial({ {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 1.0f, 0.0f });
+    int light = scene.addMaterial({ {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, 1.0f, 0.0f });
+
+    scene.addBox(-4.0f, 0.0f, -3.0f, 0.1f, 4.0f, 4.0f, red); // Left
+    scene.addBox(0.0f, 0.0f, -1.0f, 4.0f, 4.0f, 0.1f, white); // Back
+    scene.addBox(4.0f, 0.0f, -3.0f, 0.1f, 4.0f, 4.0f, green); // Right
+    scene.addBox(0.0f, -4.0f, -3.0f, 4.0f, 0.1f, 4.0f, white); // Floor
+    scene.addBox(0.0f, 4.0f, -3.0f, 4.0f, 0.1f, 4.0f, white); // Ceiling
+    scene.addBox(0.0f, 3.9f, -4.0f, 2.0f, 0.1f, 2.0f, light); // Light
+
+    // Front wall, the camera looks through it but the reflections still see it
+    scene.addBox(0.0f, 0.0f, -7.0f, 4.0f, 4.0f, 0.2f, white, true);
+
+    return scene;
+}
+
+void addRandomSpheres(PrimitiveScene &scene, int count, unsigned int seed) {
+
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int i = 0; i < count; i++) {
+
+        // Each gets its own material
+        PrimitiveMaterial material = {
+            {unit(random), unit(random), unit(random)},
+            {1.0f, 1.0f, 1.0f},
+            {0.0f, 0.0f, 0.0f},
+            unit(random),
+            unit(random) * 0.5f
+        };
+
+        int index = scene.addMaterial(material);
+
+        // Somewhere inside the walls
+        scene.addSphere(
+            -3.5f + unit(random) * 7.0f,
+            -3.5f + unit(random) * 7.0f,
+            -6.5f + unit(random) * 5.0f,
+            0.05f + unit(random) * 0.15f,
+            index
+        );
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+// C++ side of oldFragment.frag's scene: spheres and boxes with their own materials
+// Uploaded through SceneTextures, the shader walks them with the BVH in common/bvh.glsl
+
+// Primitive types (match the shader's PRIMITIVE_* defines)
+const int PRIMITIVE_SPHERE = 0;
+const int PRIMITIVE_BOX = 1;
+
+// RayTracingMaterial in oldFragment.frag
+struct PrimitiveMaterial {
+    float color[3];
+    float specularColor[3];
+    float emmisive[3];
+    float roughness;
+    float specularProbability;
+};
+
+// A Sphere or a Box
+struct Primitive {
+    int type;
+    float center[3];
+    float size[3]; // Sphere radius in size[0], box half extents
+    int material; // Index into the scene's materials
+    bool hiddenFromCamera; // Skipped by camera rays, still seen in reflections (the Cornell box's front wall)
+};
+
+// Where the shader's rays start from (the mouse still orbits it around the origin)
+struct SceneCamera {
+    float position[3] = { 0.0f, 0.0f, -20.0f };
+    float fov = 30.0f; // Vertical, in degrees
+};
+
+// Everything the shader needs
+struct PrimitiveScene {
+    std::vector<PrimitiveMaterial> materials;
+    std::vector<Primitive> primitives;
+    SceneCamera camera;
+
+    // Adds a material and returns its index
+    int addMaterial(const PrimitiveMaterial &material);
+
+    // Add primitives
+    void addSphere(float x, float y, float z, float radius, int material);
+    void addBox(float x, float y, float z, float halfX, float halfY, float halfZ, int material, bool hiddenFromCamera = false);
+
+    // Min / max corners of a primitive
+    void getBounds(int primitive, float min[3], float max[3]) const;
+};
+
+// The Cornell box oldFragment.frag used to build in calculateClosestHit
+PrimitiveScene createCornellBoxScene();
+
+// Scatters small random spheres inside the Cornell box, same seed gives the same spheres
+void addRandomSpheres(PrimitiveScene &scene, int count, unsigned int seed);
@@ -0,0 +1,198 @@
+#include "../../includes/packs/gui.h"
+
+#include "Profiler.h"
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+Profiler::Profiler() {
+
+    for (int i = 0; i < HISTORY; i++) {
+        frameHistory[i] = 0.0f;
+        frameValid[i] = false;
+    }
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Find or make a scope
+Profiler::Scope& Profiler::getScope(const std::string &name) {
+
+    for (Scope &scope : scopes) {
+        if (scope.name == name) {
+            return scope;
+        }
+    }
+
+    // First time we've seen it
+    scopes.push_back(Scope());
+    Scope &scope = scopes.back();
+
+    scope.name = name;
+    glGenQueries(FRAMES_IN_FLIGHT * 2, &scope.queries[0][0]);
+
+    for (int i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        scope.issued[i] = false;
+    }
+
+    for (int i = 0; i < HISTORY; i++) {
+        scope.gpuHistory[i] = 0.0f;
+        scope.cpuHistory[i] = 0.0f;
+        scope.gpuValid[i] = false;
+        scope.cpuValid[i] = false;
+    }
+
+    return scope;
+}
+
+// Start a frame
+void Profiler::beginFrame() {
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    // Last frame's CPU time
+    frameValid[historyIndex] = frameStarted;
+
+    if (frameStarted) {
+        frameHistory[historyIndex] = std::chrono::duration<float, std::milli>(now - frameStart).count();
+    }
+
+    frameStart = now;
+    frameStarted = true;
+
+    // Move to the slot written FRAMES_IN_FLIGHT frames ago, its results should be done by now
+    slot = (slot + 1) % FRAMES_IN_FLIGHT;
+
+    // The entry before this one, gaps repeat it so the graphs don't drop to zero
+    int previous = (historyIndex + HISTORY - 1) % HISTORY;
+
+    for (Scope &scope : scopes) {
+
+        // Skipped that frame (or not back yet)
+        float gpuMs = scope.gpuHistory[previous];
+        bool gpuValid = false;
+
+        if (scope.issued[slot]) {
+
+            // Still not done means the GPU is really behind, drop the sample rather than wait
+            GLint available = 0;
+            glGetQueryObjectiv(scope.queries[slot][1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+            if (available) {
+                GLuint64 start = 0;
+                GLuint64 end = 0;
+                glGetQueryObjectui64v(scope.queries[slot][0], GL_QUERY_RESULT, &start);
+                glGetQueryObjectui64v(scope.queries[slot][1], GL_QUERY_RESULT, &end);
+
+                gpuMs = (end - start) / 1000000.0f;
+                gpuValid = true;
+            }
+
+            scope.issued[slot] = false;
+        }
+
+        scope.gpuHistory[historyIndex] = gpuMs;
+        scope.gpuValid[historyIndex] = gpuValid;
+
+        scope.cpuHistory[historyIndex] = scope.cpuTimed ? scope.cpuMs : scope.cpuHistory[previous];
+        scope.cpuValid[historyIndex] = scope.cpuTimed;
+
+        scope.cpuMs = 0.0f;
+        scope.cpuTimed = false;
+    }
+
+    historyIndex = (historyIndex + 1) % HISTORY;
+}
+
+// Start a section
+void Profiler::begin(const std::string &name) {
+
+    Scope &scope = getScope(name);
+
+    glQueryCounter(scope.queries[slot][0], GL_TIMESTAMP);
+    scope.cpuStart = std::chrono::steady_clock::now();
+}
+
+// End a section
+void Profiler::end(const std::string &name) {
+
+    Scope &scope = getScope(name);
+
+    glQueryCounter(scope.queries[slot][1], GL_TIMESTAMP);
+    scope.issued[slot] = true;
+
+    scope.cpuMs += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - scope.cpuStart).count();
+    scope.cpuTimed = true;
+}
+
+// Newest GPU result
+float Profiler::getGpuMs(const std::string &name) {
+
+    for (Scope &scope : scopes) {
+        if (scope.name == name) {
+
+            int newest = (historyIndex + HISTORY - 1) % HISTORY;
+
+            // A repeated value would be reacted to twice
+            return scope.gpuValid[newest] ? scope.gpuHistory[newest] : 0.0f;
+        }
+    }
+
+    return 0.0f;
+}
+
+// Mean of a history's real results
+float Profiler::average(const float history[HISTORY], const bool valid[HISTORY]) {
+
+    float total = 0.0f;
+    int count = 0;
+
+    for (int i = 0; i < HISTORY; i++) {
+        if (valid[i]) {
+            total += history[i];
+            count++;
+        }
+    }
+
+    return count > 0 ? total / count : 0.0f;
+}
+
+// Timings window
+void Profiler::drawPanel() {
+
+    // Top right, out of the way of the debug window
+    ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 380.0f, 20.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(360.0f, 400.0f), ImGuiCond_FirstUseEver);
+
+    ImGui::Begin("Profiler");
+
+    // Frame time graph, the oldest value is the one about to be overwritten
+    float frameMs = average(frameHistory, frameValid);
+    ImGui::Text("Frame: %.2f ms (%.0f fps)", frameMs, frameMs > 0.0f ? 1000.0f / frameMs : 0.0f);
+    ImGui::PlotLines("##Frame", frameHistory, HISTORY, historyIndex, NULL, 0.0f, FLT_MAX, ImVec2(0, 60));
+
+    // Per scope averages with a small graph each
+    for (Scope &scope : scopes) {
+
+        ImGui::Text("%s  GPU %.2f ms  CPU %.2f ms", scope.name.c_str(), average(scope.gpuHistory, scope.gpuValid), average(scope.cpuHistory, scope.cpuValid));
+
+        ImGui::PushID(scope.name.c_str());
+        ImGui::PlotLines("##GPU", scope.gpuHistory, HISTORY, historyIndex, NULL, 0.0f, FLT_MAX, ImVec2(0, 30));
+        ImGui::PopID();
+    }
+
+    ImGui::End();
+}
+
+// Memory freeage
+void Profiler::kill() {
+
+    for (Scope &scope : scopes) {
+        glDeleteQueries(FRAMES_IN_FLIGHT * 2, &scope.queries[0][0]);
+    }
+
+    scopes.clear();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+#include "../../includes/packs/standardImports.h"
+
+#include <vector>
+#include <chrono>
+
+// Per scope GPU and CPU frame timings
+// GPU times come from GL_TIMESTAMP queries read back a few frames late so the CPU never waits on the GPU
+class Profiler {
+
+    public:
+
+        // Frames of queries in flight, results are read when a slot comes back around
+        static const int FRAMES_IN_FLIGHT = 3;
+
+        // Frames of history kept for the graphs
+        static const int HISTORY = 120;
+
+    private:
+
+        // One named section of the frame
+        struct Scope {
+            std::string name;
+
+            // Start / end timestamps for every frame in flight
+            GLuint queries[FRAMES_IN_FLIGHT][2];
+            bool issued[FRAMES_IN_FLIGHT];
+
+            // CPU side
+            std::chrono::steady_clock::time_point cpuStart;
+            float cpuMs = 0.0f;
+            bool cpuTimed = false; // Ended at least once this frame
+
+            // Rolling times in milliseconds, frames without a result repeat the one before
+            float gpuHistory[HISTORY];
+            float cpuHistory[HISTORY];
+
+            // Which history entries are real results, only those are averaged
+            bool gpuValid[HISTORY];
+            bool cpuValid[HISTORY];
+        };
+
+        std::vector<Scope> scopes;
+
+        // Which query slot this frame writes
+        int slot = 0;
+
+        // Where the next history value goes
+        int historyIndex = 0;
+
+        // Whole frame CPU time
+        std::chrono::steady_clock::time_point frameStart;
+        bool frameStarted = false;
+        float frameHistory[HISTORY];
+        bool frameValid[HISTORY];
+
+        // Get a scope by name, makes it the first time
+        Scope& getScope(const std::string &name);
+
+        // Average of a history's valid entries, 0 if it has none
+        float average(const float history[HISTORY], const bool valid[HISTORY]);
+
+    public:
+
+        // Constructor
+        // Needs a current context (queries are made as scopes show up)
+        Profiler();
+
+        // Call once at the very start of every frame, reads back the oldest frame's queries
+        void beginFrame();
+
+        // Time a section, scopes can't be nested with the same name
+        void begin(const std::string &name);
+        void end(const std::string &name);
+
+        // The newest GPU time of a scope in milliseconds (a few frames old), 0 if that frame had none
+        float getGpuMs(const std::string &name);
+
+        // Draws the timings panel, call between Window::start and Window::end
+        void drawPanel();
+
+        // Frees the queries
+        void kill();
+};
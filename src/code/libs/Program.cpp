@@ -1,12 +1,168 @@
 #include "./Program.h"
+#include "./GLExtensions.h"
 
 // ---------------------- Constructor(s) --------------------
 Program::Program(Shader vertexShader, Shader fragmentShader) {
-    
+
     // Store the shaders
     this->vertexShader = vertexShader;
     this->fragmentShader = fragmentShader;
 
+    // Link and wait for it
+    link();
+    finish();
+}
+
+
+// Vertex / Fragment Shader - from Shader::submit, they can still be compiling
+Program Program::submit(Shader vertexShader, Shader fragmentShader) {
+
+    Program program;
+
+    // Store the shaders
+    program.vertexShader = vertexShader;
+    program.fragmentShader = fragmentShader;
+
+    // The driver can link once the compiles are done without us asking about them first
+    program.link();
+
+    return program;
+}
+
+
+// Binary Format - the format the driver gave with the binary
+// Binary - a program binary from getBinary, possibly from an earlier run
+Program::Program(GLenum binaryFormat, const std::vector<char> &binary) {
+
+    // Create a new program
+    this->program = glCreateProgram();
+
+    // Load the already linked binary
+    GLExtensions::glProgramBinary(program, binaryFormat, binary.data(), (GLsizei)binary.size());
+
+    // The driver rejects binaries from other versions, so check it took
+    int succsess;
+    glGetProgramiv(program, GL_LINK_STATUS, &succsess);
+    linked = succsess;
+
+    // Cache every uniform location so the setters never have to ask the driver
+    if (linked) {
+        loadUniforms();
+    }
+}
+
+
+// -------------------------- Seters -----------------------
+
+
+// Int
+void Program::setInt(const std::string &name, int value)
+{ 
+    setInt(getUniformLocation(name), value); 
+}
+
+// Float
+void Program::setFloat(const std::string &name, float value)
+{ 
+    setFloat(getUniformLocation(name), value); 
+} 
+
+// Bool
+void Program::setBool(const std::string &name, bool value)
+{         
+    setBool(getUniformLocation(name), value); 
+}
+
+// Array 2 float
+void Program::setArrayf2(const std::string &name, float value[2]) {
+    setArrayf2(getUniformLocation(name), value);
+}
+
+// Array 3 float
+void Program::setArrayf3(const std::string &name, float value[3]) {
+    setArrayf3(getUniformLocation(name), value);
+}
+
+
+// Int (handle)
+void Program::setInt(GLint location, int value) {
+    uniformState.setInt(location, value);
+}
+
+// Float (handle)
+void Program::setFloat(GLint location, float value) {
+    uniformState.setFloat(location, value);
+}
+
+// Bool (handle)
+void Program::setBool(GLint location, bool value) {
+    uniformState.setInt(location, (int)value);
+}
+
+// Array 2 float (handle)
+void Program::setArrayf2(GLint location, float value[2]) {
+    uniformState.setArrayf2(location, value);
+}
+
+// Array 3 float (handle)
+void Program::setArrayf3(GLint location, float value[3]) {
+    uniformState.setArrayf3(location, value);
+}
+
+
+// -------------------------- Getters -----------------------
+
+
+// Look up a uniform's handle in the table
+// Returns -1 (which glUniform* silently ignores) when the uniform isn't active
+GLint Program::getUniformLocation(const std::string &name) {
+
+    // Find the uniform
+    std::unordered_map<std::string, GLint>::iterator uniform = uniforms.find(name);
+
+    // Not found
+    if (uniform == uniforms.end()) {
+        return -1;
+    }
+
+    return uniform->second;
+}
+
+
+// Point a sampler at a unit
+void Program::bindSampler(const std::string &name, GLuint unit, GLenum target, GLuint texture) {
+
+    // Samplers are plain int uniforms
+    setInt(name, (int)unit);
+
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(target, texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+
+// Tie a uniform block to a binding point
+bool Program::bindUniformBlock(const std::string &name, GLuint binding) {
+
+    // Find the block
+    GLuint blockIndex = glGetUniformBlockIndex(program, name.c_str());
+
+    // This shader doesn't use it
+    if (blockIndex == GL_INVALID_INDEX) {
+        return false;
+    }
+
+    glUniformBlockBinding(program, blockIndex, binding);
+    return true;
+}
+
+
+// --------------------------- Methods ----------------------
+
+
+// Start linking
+void Program::link() {
+
     // Create a new program
     this->program = glCreateProgram();
 
@@ -14,12 +170,43 @@ Program::Program(Shader vertexShader, Shader fragmentShader) {
     glAttachShader(program, vertexShader.getShader()); // Vertex Shader
     glAttachShader(program, fragmentShader.getShader()); // Fragment Shader
 
-    // Link all the parts together in our program
+    // Ask the driver to keep the binary around so ProgramCache can save it
+    if (GLExtensions::programBinary) {
+        GLExtensions::glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // Link all the parts together in our program (with KHR_parallel_shader_compile this returns before it's done)
     glLinkProgram(program);
+}
+
+
+// Ask if the driver is done without blocking
+bool Program::isComplete() {
+
+    // Without the extension the status queries in finish are what wait
+    if (!GLExtensions::parallelShaderCompile) {
+        return true;
+    }
+
+    // Linking finishes after the compiles it needs
+    int complete = 0;
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &complete);
+
+    return complete;
+}
+
+
+// Check the compiles and the link
+void Program::finish() {
+
+    // Compile errors first, they're what usually breaks the link
+    vertexShader.checkCompile();
+    fragmentShader.checkCompile();
 
     // Then error check
     int succsess; // Error output
     glGetProgramiv(program, GL_LINK_STATUS, &succsess); // Get the program iv
+    linked = succsess;
 
     // Check for an error
     if (!succsess) { 
@@ -38,6 +225,9 @@ Program::Program(Shader vertexShader, Shader fragmentShader) {
     // Validate our program
     glValidateProgram(program);
 
+    // Cache every uniform location so the setters never have to ask the driver
+    loadUniforms();
+
     // Detach our shaders now that they are linked
     glDetachShader(program, vertexShader.getShader());
     glDetachShader(program, fragmentShader.getShader());
@@ -48,39 +238,93 @@ Program::Program(Shader vertexShader, Shader fragmentShader) {
 }
 
 
-// -------------------------- Seters -----------------------
-
 
-// Int
-void Program::setInt(const std::string &name, int value)
-{ 
-    glUniform1i(glGetUniformLocation(program, name.c_str()), value); 
+// Use our program
+void Program::use() {
+    glUseProgram(program);
 }
 
-// Float
-void Program::setFloat(const std::string &name, float value)
-{ 
-    glUniform1f(glGetUniformLocation(program, name.c_str()), value); 
-} 
 
-// Bool
-void Program::setBool(const std::string &name, bool value)
-{         
-    glUniform1i(glGetUniformLocation(program, name.c_str()), (int)value); 
+// Upload the uniforms that changed since the last flush
+void Program::flushUniforms() {
+    uniformState.flush();
 }
 
-// Array 3 float
-void Program::setArrayf3(const std::string &name, float value[3]) {
-    glUniform3f(glGetUniformLocation(program, name.c_str()), value[0], value[1], value[2]);
+
+// Get the linked program's binary
+// Returns false if the driver can't give one
+bool Program::getBinary(GLenum &binaryFormat, std::vector<char> &binary) {
+
+    // Nothing to save
+    if (!GLExtensions::programBinary || !linked) {
+        return false;
+    }
+
+    // Get how big the binary is
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    if (length <= 0) {
+        return false;
+    }
+
+    // Then get the binary itself
+    binary.resize(length);
+    GLsizei written = 0;
+    GLExtensions::glGetProgramBinary(program, length, &written, &binaryFormat, binary.data());
+    binary.resize(written);
+
+    return written > 0;
 }
 
 
-// --------------------------- Methods ----------------------
+// Fill the uniform table with every active uniform in the linked program
+void Program::loadUniforms() {
 
+    // Start fresh
+    uniforms.clear();
 
-// Use our program
-void Program::use() {
-    glUseProgram(program);
+    // Get how many uniforms there are and the longest name
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    // Buffer for the names
+    std::vector<char> nameBuffer(maxNameLength + 1);
+
+    // Loop every active uniform
+    for (GLint i = 0; i < uniformCount; i++) {
+
+        // Get the uniform's info
+        GLsizei nameLength = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, i, (GLsizei)nameBuffer.size(), &nameLength, &size, &type, nameBuffer.data());
+
+        std::string name(nameBuffer.data(), nameLength);
+
+        // Find the location (uniform block members don't have one)
+        GLint location = glGetUniformLocation(program, name.c_str());
+
+        if (location == -1) {
+            continue;
+        }
+
+        uniforms[name] = location;
+
+        // Arrays are reported as "name[0]", so also store the base name and every other element
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+
+            std::string baseName = name.substr(0, name.size() - 3);
+            uniforms[baseName] = location;
+
+            for (GLint element = 1; element < size; element++) {
+                std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                uniforms[elementName] = glGetUniformLocation(program, elementName.c_str());
+            }
+        }
+    }
 }
 
 
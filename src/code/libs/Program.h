@@ -4,8 +4,10 @@
 #include "../../includes/packs/fileImports.h"
 
 #include <vector>
+#include <unordered_map>
 
 #include "./Shader.h"
+#include "./UniformState.h"
 
 class Program {
     
@@ -17,28 +19,91 @@ class Program {
         // Hold our main program
         GLint program;
 
+        // If linking (or loading the binary) worked
+        bool linked = false;
+
+        // Every active uniform's location by name, filled once after linking
+        // Array elements ("name[i]") and struct members ("name.member") get their own entries
+        std::unordered_map<std::string, GLint> uniforms;
+
+        // Last uploaded uniform values, setters only stage into this
+        UniformState uniformState;
+
+        // Query all the active uniforms and fill the uniform table
+        void loadUniforms();
+
+        // Attach the shaders and start linking, without waiting on it
+        void link();
+
     public:
 
         // Constructor
         // Takes in two shaders
         Program(Shader vertexShader, Shader fragmentShader);
 
-        // Setters
+        // Starts linking two submitted shaders without waiting on either, see isComplete and finish
+        static Program submit(Shader vertexShader, Shader fragmentShader);
+
+        // Loads an already linked program binary (see getBinary / ProgramCache)
+        Program(GLenum binaryFormat, const std::vector<char> &binary);
+
+        // Setters (by name, looked up in the uniform table)
+        // Values are staged and only uploaded by flushUniforms if they changed
         void setBool(const std::string &name, bool value);
         void setInt(const std::string &name, int value);
         void setFloat(const std::string &name, float value);
+        void setArrayf2(const std::string &name, float value[2]);
         void setArrayf3(const std::string &name, float value[3]);
 
+        // Setters (by handle from getUniformLocation, no lookup at all)
+        void setBool(GLint location, bool value);
+        void setInt(GLint location, int value);
+        void setFloat(GLint location, float value);
+        void setArrayf2(GLint location, float value[2]);
+        void setArrayf3(GLint location, float value[3]);
+
         // Getters
         GLuint getProgram() { return program; };
 
+        // Returns true once the driver finished compiling and linking (always with no KHR_parallel_shader_compile)
+        bool isComplete();
+
+        // Waits for a submitted program, prints the logs and fills the uniform table
+        void finish();
+
+        // Returns true if the program linked and can be used
+        bool isLinked() { return linked; };
+
+        // Gets the linked program's binary, returns false if the driver can't
+        bool getBinary(GLenum &binaryFormat, std::vector<char> &binary);
+
+        // Returns the handle of a uniform, or -1 if the program doesn't use it
+        GLint getUniformLocation(const std::string &name);
+
+        // Returns true if the program uses the uniform
+        bool hasUniform(const std::string &name) { return getUniformLocation(name) != -1; };
+
+        // Points a sampler uniform at a texture unit and binds the texture there, unit 0 is left active
+        // Call it before every draw that reads the texture, something else could have used the unit since
+        void bindSampler(const std::string &name, GLuint unit, GLenum target, GLuint texture);
+
+        // Ties a uniform block to a buffer binding point
+        // Returns false if the program has no block with that name
+        bool bindUniformBlock(const std::string &name, GLuint binding);
+
+        // Returns the staged uniform values and their upload stats
+        UniformState& getUniformState() { return uniformState; };
+
 
         // Uses our program
         void use();
 
+        // Uploads every staged uniform that changed, the program must be in use
+        void flushUniforms();
+
 
         // Kills our program and frees memory
         void kill();
 
         Program() {};
-};
\ No newline at end of file
+};
@@ -0,0 +1,210 @@
+#include "ProgramCache.h"
+#include "GLExtensions.h"
+
+#include <sstream>
+#include <iomanip>
+
+
+// Written at the start of every cache file
+static const char CACHE_MAGIC[4] = {'S', 'H', 'P', 'B'};
+
+// A driver string, empty if the driver doesn't give one (glGetString returns NULL on errors)
+static std::string driverString(GLenum name) {
+    const char* value = (const char*)glGetString(name);
+    return value != NULL ? value : "";
+}
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Directory - where binaries are saved, created if it doesn't exist
+ProgramCache::ProgramCache(const std::string &directory) {
+
+    this->directory = directory;
+
+    // Binaries are only valid for the exact driver, so it's part of every key
+    driver = driverString(GL_VENDOR) + "|" + driverString(GL_RENDERER) + "|" + driverString(GL_VERSION);
+
+    // Make the folder
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Build (or load) a program from its paths
+Program ProgramCache::load(const char* vertexPath, const char* fragmentPath) {
+    return load(Shader::readSource(vertexPath), Shader::readSource(fragmentPath));
+}
+
+// Build (or load) a specialized program from its paths
+Program ProgramCache::load(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines) {
+    return load(Shader::readSource(vertexPath, defines), Shader::readSource(fragmentPath, defines));
+}
+
+// Build (or load) a program from its sources
+Program ProgramCache::load(const std::string &vertexSource, const std::string &fragmentSource) {
+
+    // Try the cache first
+    Program program;
+
+    if (loadCached(vertexSource, fragmentSource, program)) {
+        return program;
+    }
+
+    // Compile and link like normal
+    program = submit(vertexSource, fragmentSource);
+    program.finish();
+
+    // Save it for next time
+    store(vertexSource, fragmentSource, program);
+
+    return program;
+}
+
+// Load a program from its cached binary
+bool ProgramCache::loadCached(const std::string &vertexSource, const std::string &fragmentSource, Program &program) {
+
+    if (!GLExtensions::programBinary) {
+        return false;
+    }
+
+    uint64_t key = hash(vertexSource, fragmentSource);
+
+    GLenum binaryFormat;
+    std::vector<char> binary;
+
+    if (!readEntry(key, binaryFormat, binary)) {
+        return false;
+    }
+
+    Program cached(binaryFormat, binary);
+
+    // Driver accepted it
+    if (cached.isLinked()) {
+        hits++;
+        std::cout << "Program loaded from cache" << std::endl;
+        program = cached;
+        return true;
+    }
+
+    // Stale binary, throw it away and build normally
+    cached.kill();
+    std::error_code error;
+    std::filesystem::remove(entryPath(key), error);
+
+    return false;
+}
+
+// Start building a program from its sources
+Program ProgramCache::submit(const std::string &vertexSource, const std::string &fragmentSource) {
+
+    misses++;
+
+    // Both compiles and the link are queued before anything is asked about them
+    Shader vertex = Shader::submit(vertexSource, GL_VERTEX_SHADER);
+    Shader fragment = Shader::submit(fragmentSource, GL_FRAGMENT_SHADER);
+
+    return Program::submit(vertex, fragment);
+}
+
+// Save a finished program
+void ProgramCache::store(const std::string &vertexSource, const std::string &fragmentSource, Program &program) {
+
+    GLenum binaryFormat;
+    std::vector<char> binary;
+
+    if (program.getBinary(binaryFormat, binary)) {
+        writeEntry(hash(vertexSource, fragmentSource), binaryFormat, binary);
+    }
+}
+
+// FNV-1a over both sources and the driver string
+uint64_t ProgramCache::hash(const std::string &vertexSource, const std::string &fragmentSource) {
+
+    uint64_t value = 14695981039346656037ull;
+
+    // Mix in every part with a separator between them so "ab"+"c" != "a"+"bc"
+    const std::string* parts[3] = {&vertexSource, &fragmentSource, &driver};
+
+    for (const std::string* part : parts) {
+        for (unsigned char c : *part) {
+            value ^= c;
+            value *= 1099511628211ull;
+        }
+
+        value ^= 0xff;
+        value *= 1099511628211ull;
+    }
+
+    return value;
+}
+
+// Where a key's binary lives
+std::filesystem::path ProgramCache::entryPath(uint64_t key) {
+    std::stringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return directory / name.str();
+}
+
+// Read a binary from the cache
+bool ProgramCache::readEntry(uint64_t key, GLenum &binaryFormat, std::vector<char> &binary) {
+
+    std::ifstream file(entryPath(key), std::ios::binary);
+
+    // Not cached
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Check the header
+    char magic[4];
+    uint32_t format = 0;
+    uint64_t length = 0;
+
+    file.read(magic, sizeof(magic));
+    file.read((char*)&format, sizeof(format));
+    file.read((char*)&length, sizeof(length));
+
+    if (!file || std::string(magic, 4) != std::string(CACHE_MAGIC, 4) || length == 0) {
+        return false;
+    }
+
+    // Then the binary
+    binary.resize(length);
+    file.read(binary.data(), length);
+
+    binaryFormat = format;
+    return (bool)file;
+}
+
+// Write a binary to the cache
+void ProgramCache::writeEntry(uint64_t key, GLenum binaryFormat, const std::vector<char> &binary) {
+
+    // Write to a temporary file then rename so a crash never leaves half a binary
+    std::filesystem::path path = entryPath(key);
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+
+    std::ofstream file(temporary, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cout << "Couldn't write program cache " << path << std::endl;
+        return;
+    }
+
+    uint32_t format = binaryFormat;
+    uint64_t length = binary.size();
+
+    file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    file.write((const char*)&format, sizeof(format));
+    file.write((const char*)&length, sizeof(length));
+    file.write(binary.data(), binary.size());
+    file.close();
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+}
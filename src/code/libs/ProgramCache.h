@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+#include "../../includes/packs/fileImports.h"
+
+#include <filesystem>
+#include <cstdint>
+
+#include "./Program.h"
+
+class ProgramCache {
+
+    private:
+
+        // Where the binaries are saved
+        std::filesystem::path directory;
+
+        // Vendor, renderer and version, binaries only work on the driver that made them
+        std::string driver;
+
+        // Stats
+        int hits = 0;
+        int misses = 0;
+
+        // Hash the sources together with the driver
+        uint64_t hash(const std::string &vertexSource, const std::string &fragmentSource);
+
+        // The file a key's binary lives in
+        std::filesystem::path entryPath(uint64_t key);
+
+        // Read and write binaries
+        bool readEntry(uint64_t key, GLenum &binaryFormat, std::vector<char> &binary);
+        void writeEntry(uint64_t key, GLenum binaryFormat, const std::vector<char> &binary);
+
+    public:
+
+        // Constructor
+        // Takes the cache directory, a context must be current
+        ProgramCache(const std::string &directory);
+
+        // Builds a program from source, loading the cached binary instead when the sources haven't changed
+        Program load(const std::string &vertexSource, const std::string &fragmentSource);
+
+        // Same as above but reads the shader files first
+        Program load(const char* vertexPath, const char* fragmentPath);
+
+        // Same again with defines injected into both shaders (each set caches separately)
+        Program load(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines);
+
+        // The three parts of load, for callers that want to wait on the driver themselves
+        // Returns true and fills program if the sources' binary was cached and the driver took it
+        bool loadCached(const std::string &vertexSource, const std::string &fragmentSource, Program &program);
+
+        // Starts compiling and linking without waiting (see Program::isComplete / finish)
+        Program submit(const std::string &vertexSource, const std::string &fragmentSource);
+
+        // Saves a finished program's binary under its sources
+        void store(const std::string &vertexSource, const std::string &fragmentSource, Program &program);
+
+        // Getters
+        int getHits() { return hits; };
+        int getMisses() { return misses; };
+
+        ProgramCache() {};
+};
@@ -0,0 +1,92 @@
+#include "ProgramVariants.h"
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+std::string ProgramVariants::key(const std::string &fragmentPath, const ShaderDefines &defines) {
+    return fragmentPath + "|" + Shader::definesKey(defines);
+}
+
+// Look a variant up
+bool ProgramVariants::find(const std::string &fragmentPath, const ShaderDefines &defines, Program &program) {
+
+    std::unordered_map<std::string, Variant>::iterator found = programs.find(key(fragmentPath, defines));
+
+    // Stale ones are built from the old files
+    if (found == programs.end() || found->second.stale) {
+        return false;
+    }
+
+    program = found->second.program;
+
+    // Whatever we last staged might not be what's uploaded anymore
+    program.getUniformState().reset();
+
+    return true;
+}
+
+// Keep a variant
+void ProgramVariants::add(const std::string &fragmentPath, const ShaderDefines &defines, Program program, GLuint inUse) {
+
+    Variant &slot = programs[key(fragmentPath, defines)];
+
+    // A rebuild of the same variant replaces the old one, which can't be freed while it's still drawn
+    if (slot.program.isLinked() && slot.program.getProgram() != program.getProgram()) {
+
+        if (slot.program.getProgram() == inUse) {
+            retired.push_back(slot.program);
+        }
+
+        else {
+            slot.program.kill();
+        }
+    }
+
+    slot.program = program;
+    slot.stale = false;
+}
+
+// Throw away stale variants
+void ProgramVariants::invalidate(GLuint keep) {
+
+    for (std::unordered_map<std::string, Variant>::iterator i = programs.begin(); i != programs.end(); ) {
+
+        // Still drawn, it stays until its rebuild replaces it
+        if (i->second.program.getProgram() == keep) {
+            i->second.stale = true;
+            i++;
+            continue;
+        }
+
+        i->second.program.kill();
+        i = programs.erase(i);
+    }
+
+    // Older ones that aren't drawn anymore
+    for (std::vector<Program>::iterator i = retired.begin(); i != retired.end(); ) {
+
+        if (i->getProgram() == keep) {
+            i++;
+            continue;
+        }
+
+        i->kill();
+        i = retired.erase(i);
+    }
+}
+
+// Memory freeage
+void ProgramVariants::kill() {
+
+    for (std::pair<const std::string, Variant> &entry : programs) {
+        entry.second.program.kill();
+    }
+
+    for (Program &program : retired) {
+        program.kill();
+    }
+
+    programs.clear();
+    retired.clear();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./Program.h"
+#include "./Shader.h"
+
+// Linked programs kept per (fragment file, defines) variant
+// Switching to a variant that was built before is instant, nothing gets compiled or branched on at runtime
+class ProgramVariants {
+
+    private:
+
+        // One linked variant
+        struct Variant {
+            Program program;
+            bool stale = false; // Built from files that changed since, never found until its rebuild is added
+        };
+
+        // Every linked variant by key
+        std::unordered_map<std::string, Variant> programs;
+
+        // Replaced while they were still being drawn, killed by the next invalidate (or kill)
+        std::vector<Program> retired;
+
+        // "path|A=1;B=2;"
+        static std::string key(const std::string &fragmentPath, const ShaderDefines &defines);
+
+    public:
+
+        // Returns true and fills program if the variant is already linked
+        // Its uniform state is reset since another copy may have changed the real values
+        bool find(const std::string &fragmentPath, const ShaderDefines &defines, Program &program);
+
+        // Keeps a linked program, an older build of the same variant is killed (unless it's the one in use)
+        void add(const std::string &fragmentPath, const ShaderDefines &defines, Program program, GLuint inUse = 0);
+
+        // The shader files changed, kills every variant except the one being drawn
+        // That one is kept alive but isn't found anymore, until its rebuild is added
+        void invalidate(GLuint keep);
+
+        // Getters
+        int getCount() { return (int)programs.size(); };
+
+        // Kills every program
+        void kill();
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+// C++ mirrors of the std140 SceneBlock in fragment.frag
+// Every struct is padded by hand so it can be uploaded to the uniform buffer as-is
+
+// Number of spheres in the block, keep in sync with SPHERE_NUM in the shaders
+const int SCENE_SPHERE_NUM = 3;
+
+// The uniform buffer binding point every program's SceneBlock is tied to
+const unsigned int SCENE_BLOCK_BINDING = 0;
+
+// Object materials (RayTracingMaterial in the shader)
+struct RayTracingMaterial {
+    float albedo[3];
+    float emmisive;
+    float metallic;
+    float roughness;
+    float padding[2] = {}; // std140 rounds structs up to 16 bytes
+};
+
+// Ball (Sphere in the shader)
+struct Sphere {
+    float position[3];
+    float radius;
+    RayTracingMaterial material;
+};
+
+// The whole block
+struct SceneBlock {
+    Sphere spheres[SCENE_SPHERE_NUM];
+    float ambient;
+    float padding[3] = {};
+};
+
+// The fragment.frag scene the app starts with (the CPU tracer uses it too)
+inline SceneBlock createDefaultScene() {
+
+    SceneBlock scene = {};
+
+    // Big ground sphere
+    scene.spheres[0] = { {3.0f, -18.0f, 20.0f}, 20.0f, { {0.0f, 0.0f, 1.0f}, 0.0f, 0.0f, 1.0f } };
+
+    // Small sphere
+    scene.spheres[1] = { {0.0f, 0.0f, 10.0f}, 2.0f, { {0.0f, 0.0f, 1.0f}, 0.0f, 0.0f, 1.0f } };
+
+    // Light
+    scene.spheres[2] = { {-100.0f, 0.0f, 100.0f}, 80.0f, { {1.0f, 1.0f, 1.0f}, 1.0f, 0.0f, 1.0f } };
+
+    return scene;
+}
+
+// Make sure nothing drifted from the std140 layout
+static_assert(sizeof(RayTracingMaterial) == 32, "RayTracingMaterial must match its std140 size");
+static_assert(sizeof(Sphere) == 48, "Sphere must match its std140 size");
+static_assert(sizeof(SceneBlock) == 48 * SCENE_SPHERE_NUM + 16, "SceneBlock must match its std140 size");
@@ -0,0 +1,351 @@
+#include "SceneFile.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+// ------------------------------ Mapping ---------------------------------------
+
+
+// A whole file in memory, mapped where we can and read in otherwise
+struct MappedFile {
+
+    const char* data = NULL;
+    size_t size = 0;
+
+    // Only used when mapping isn't available
+    std::vector<char> contents;
+
+    bool open(const std::string &path) {
+
+#ifndef _WIN32
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+
+        struct stat info;
+        if (fstat(file, &info) != 0 || info.st_size == 0) {
+            ::close(file);
+            return false;
+        }
+
+        void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+
+        if (mapping == MAP_FAILED) return false;
+
+        data = (const char*)mapping;
+        size = info.st_size;
+        return true;
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+
+        contents.resize((size_t)file.tellg());
+        file.seekg(0);
+        file.read(contents.data(), contents.size());
+
+        data = contents.data();
+        size = contents.size();
+        return (bool)file && size > 0;
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (data != NULL) munmap((void*)data, size);
+#endif
+    }
+};
+
+
+// ------------------------------- Binary ---------------------------------------
+
+
+static bool loadBinary(const MappedFile &file, PrimitiveScene &scene) {
+
+    if (file.size < sizeof(SceneFileHeader)) return false;
+
+    SceneFileHeader header;
+    memcpy(&header, file.data, sizeof(header));
+
+    if (header.version != SCENE_FILE_VERSION) {
+        std::cout << "Scene file version " << header.version << " isn't supported" << std::endl;
+        return false;
+    }
+
+    // Everything the header promises has to be there
+    size_t materialBytes = (size_t)header.materialCount * sizeof(PrimitiveMaterial);
+    size_t primitiveBytes = (size_t)header.primitiveCount * sizeof(SceneFilePrimitive);
+
+    if (file.size < sizeof(SceneFileHeader) + materialBytes + primitiveBytes) {
+        std::cout << "Scene file is truncated" << std::endl;
+        return false;
+    }
+
+    PrimitiveScene loaded;
+
+    memcpy(loaded.camera.position, header.cameraPosition, sizeof(header.cameraPosition));
+    loaded.camera.fov = header.cameraFov;
+
+    // Materials are stored exactly as we keep them, one copy
+    const char* materials = file.data + sizeof(SceneFileHeader);
+    loaded.materials.resize(header.materialCount);
+    memcpy(loaded.materials.data(), materials, materialBytes);
+
+    // Primitives only need the bool unpacked
+    const char* primitives = materials + materialBytes;
+    loaded.primitives.resize(header.primitiveCount);
+
+    for (uint32_t i = 0; i < header.primitiveCount; i++) {
+
+        SceneFilePrimitive record;
+        memcpy(&record, primitives + i * sizeof(SceneFilePrimitive), sizeof(record));
+
+        if (record.material < 0 || record.material >= (int32_t)header.materialCount) {
+            std::cout << "Scene file primitive " << i << " has a bad material" << std::endl;
+            return false;
+        }
+
+        Primitive &primitive = loaded.primitives[i];
+        primitive.type = record.type;
+        memcpy(primitive.center, record.center, sizeof(record.center));
+        memcpy(primitive.size, record.size, sizeof(record.size));
+        primitive.material = record.material;
+        primitive.hiddenFromCamera = record.hiddenFromCamera != 0;
+    }
+
+    scene = std::move(loaded);
+    return true;
+}
+
+bool saveSceneBinary(const std::string &path, const PrimitiveScene &scene) {
+
+    std::ofstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cout << "Couldn't write scene file " << path << std::endl;
+        return false;
+    }
+
+    SceneFileHeader header;
+    memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic));
+    header.version = SCENE_FILE_VERSION;
+    header.materialCount = scene.materials.size();
+    header.primitiveCount = scene.primitives.size();
+    memcpy(header.cameraPosition, scene.camera.position, sizeof(header.cameraPosition));
+    header.cameraFov = scene.camera.fov;
+
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)scene.materials.data(), scene.materials.size() * sizeof(PrimitiveMaterial));
+
+    for (const Primitive &primitive : scene.primitives) {
+
+        SceneFilePrimitive record;
+        record.type = primitive.type;
+        memcpy(record.center, primitive.center, sizeof(record.center));
+        memcpy(record.size, primitive.size, sizeof(record.size));
+        record.material = primitive.material;
+        record.hiddenFromCamera = primitive.hiddenFromCamera ? 1 : 0;
+
+        file.write((const char*)&record, sizeof(record));
+    }
+
+    return (bool)file;
+}
+
+
+// -------------------------------- Text ----------------------------------------
+
+
+// Walks the words of one line, straight out of the mapped file
+struct LineReader {
+
+    const char* position;
+    const char* end;
+
+    // Next word, empty at the end of the line
+    std::string_view word() {
+
+        while (position < end && (*position == ' ' || *position == '\t' || *position == '\r')) position++;
+
+        const char* start = position;
+        while (position < end && *position != ' ' && *position != '\t' && *position != '\r') position++;
+
+        return std::string_view(start, position - start);
+    }
+
+    // Next word as a number, false if it isn't one
+    bool number(float &value) {
+        std::string_view text = word();
+        std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    bool numbers(float* values, int count) {
+        for (int i = 0; i < count; i++) {
+            if (!number(values[i])) return false;
+        }
+        return true;
+    }
+};
+
+static bool loadText(const MappedFile &file, PrimitiveScene &scene) {
+
+    const char* end = file.data + file.size;
+
+    // Count the records first so every array is allocated once
+    int materialCount = 0;
+    int primitiveCount = 0;
+
+    for (const char* line = file.data; line < end; ) {
+
+        const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+        if (lineEnd == NULL) lineEnd = end;
+
+        LineReader reader = { line, lineEnd };
+        std::string_view kind = reader.word();
+
+        if (kind == "material") materialCount++;
+        if (kind == "sphere" || kind == "box") primitiveCount++;
+        if (kind == "light") { materialCount++; primitiveCount++; }
+
+        line = lineEnd + 1;
+    }
+
+    PrimitiveScene loaded;
+    loaded.materials.reserve(materialCount);
+    loaded.primitives.reserve(primitiveCount);
+
+    // Material names point into the file, no copies
+    std::vector<std::string_view> materialNames;
+    materialNames.reserve(materialCount);
+
+    int lineNumber = 0;
+
+    for (const char* line = file.data; line < end; ) {
+
+        const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+        if (lineEnd == NULL) lineEnd = end;
+
+        lineNumber++;
+
+        LineReader reader = { line, lineEnd };
+        line = lineEnd + 1;
+
+        std::string_view kind = reader.word();
+
+        // Blank or a comment
+        if (kind.empty() || kind[0] == '#') continue;
+
+        bool valid = true;
+
+        if (kind == "camera") {
+            valid = reader.numbers(loaded.camera.position, 3) && reader.number(loaded.camera.fov);
+        }
+
+        else if (kind == "material") {
+
+            std::string_view name = reader.word();
+
+            PrimitiveMaterial material;
+            valid = !name.empty()
+                && reader.numbers(material.color, 3)
+                && reader.numbers(material.specularColor, 3)
+                && reader.numbers(material.emmisive, 3)
+                && reader.number(material.roughness)
+                && reader.number(material.specularProbability);
+
+            if (valid) {
+                loaded.addMaterial(material);
+                materialNames.push_back(name);
+            }
+        }
+
+        else if (kind == "sphere" || kind == "box") {
+
+            bool sphere = kind == "sphere";
+
+            float values[6];
+            valid = reader.numbers(values, sphere ? 4 : 6);
+
+            // Look the material up by name
+            std::string_view name = reader.word();
+            int material = -1;
+
+            for (size_t i = 0; i < materialNames.size(); i++) {
+                if (!name.empty() && materialNames[i] == name) material = (int)i;
+            }
+
+            if (valid && material == -1) {
+                std::cout << "Scene line " << lineNumber << ": unknown material " << name << std::endl;
+                return false;
+            }
+
+            if (valid && sphere) {
+                loaded.addSphere(values[0], values[1], values[2], values[3], material);
+            }
+
+            if (valid && !sphere) {
+                bool hidden = reader.word() == "hidden";
+                loaded.addBox(values[0], values[1], values[2], values[3], values[4], values[5], material, hidden);
+            }
+        }
+
+        else if (kind == "light") {
+
+            float values[9];
+            valid = reader.numbers(values, 9);
+
+            if (valid) {
+                int material = loaded.addMaterial({ {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {values[6], values[7], values[8]}, 1.0f, 0.0f });
+                materialNames.push_back(std::string_view());
+                loaded.addBox(values[0], values[1], values[2], values[3], values[4], values[5], material);
+            }
+        }
+
+        else {
+            std::cout << "Scene line " << lineNumber << ": unknown record " << kind << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cout << "Scene line " << lineNumber << ": bad " << kind << std::endl;
+            return false;
+        }
+    }
+
+    scene = std::move(loaded);
+    return true;
+}
+
+
+// ------------------------------- Loading --------------------------------------
+
+
+bool loadSceneFile(const std::string &path, PrimitiveScene &scene) {
+
+    MappedFile file;
+
+    if (!file.open(path)) {
+        std::cout << "Couldn't open scene file " << path << std::endl;
+        return false;
+    }
+
+    // Binary files start with the magic, text files never do
+    if (file.size >= sizeof(SCENE_FILE_MAGIC) && memcmp(file.data, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC)) == 0) {
+        return loadBinary(file, scene);
+    }
+
+    return loadText(file, scene);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "./PrimitiveScene.h"
+
+// Scene files for PrimitiveScene, so changing the layout is a buffer upload instead of a shader rebuild
+//
+// Text (.scene), one record per line, # starts a comment:
+//   camera   x y z fov
+//   material name  r g b  specularR specularG specularB  emmisiveR emmisiveG emmisiveB  roughness specularProbability
+//   sphere   x y z radius material
+//   box      x y z halfX halfY halfZ material [hidden]
+//   light    x y z halfX halfY halfZ r g b    (an emmisive box)
+// Materials have to come before the primitives that use them
+//
+// Binary (.sceneb), memory mapped and copied straight into the scene:
+//   SceneFileHeader, then materialCount PrimitiveMaterial, then primitiveCount SceneFilePrimitive
+
+// "SCNB"
+const char SCENE_FILE_MAGIC[4] = { 'S', 'C', 'N', 'B' };
+const uint32_t SCENE_FILE_VERSION = 1;
+
+// Start of a binary scene
+struct SceneFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t materialCount;
+    uint32_t primitiveCount;
+    float cameraPosition[3];
+    float cameraFov;
+};
+
+// A Primitive on disk, fixed size so the file doesn't depend on the compiler's bool
+struct SceneFilePrimitive {
+    int32_t type;
+    float center[3];
+    float size[3];
+    int32_t material;
+    int32_t hiddenFromCamera;
+};
+
+static_assert(sizeof(SceneFileHeader) == 32, "SceneFileHeader must stay 32 bytes");
+static_assert(sizeof(PrimitiveMaterial) == 44, "PrimitiveMaterial is written as 11 floats");
+static_assert(sizeof(SceneFilePrimitive) == 36, "SceneFilePrimitive must stay 36 bytes");
+
+// Loads either format (binary files are told apart by their magic), replacing the scene
+// Returns false and leaves the scene alone if the file is missing or broken
+bool loadSceneFile(const std::string &path, PrimitiveScene &scene);
+
+// Writes the binary form
+bool saveSceneBinary(const std::string &path, const PrimitiveScene &scene);
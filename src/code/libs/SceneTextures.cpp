@@ -0,0 +1,82 @@
+#include "SceneTextures.h"
+
+#include <vector>
+#include <algorithm>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Create - only here so the default constructor doesn't touch GL
+SceneTextures::SceneTextures(bool create) {
+
+    if (!create) return;
+
+    nodes = TextureBuffer(BVH_NODES_UNIT, GL_RGBA32F);
+    primitives = TextureBuffer(BVH_PRIMITIVES_UNIT, GL_RGBA32F);
+    materials = TextureBuffer(BVH_MATERIALS_UNIT, GL_RGBA32F);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+void SceneTextures::upload(const PrimitiveScene &scene, const Bvh &bvh) {
+
+    // Nodes are already laid out as two texels
+    const std::vector<BvhNode> &nodeData = bvh.getNodes();
+    nodes.update(nodeData.data(), nodeData.size() * sizeof(BvhNode));
+
+    // Primitives in the order the leaves point at
+    // [center, type | hiddenFromCamera << 1] [size, material]
+    const std::vector<int> &order = bvh.getOrder();
+    std::vector<float> primitiveData;
+    primitiveData.reserve(order.size() * 8 + 8);
+
+    for (int index : order) {
+
+        const Primitive &primitive = scene.primitives[index];
+
+        primitiveData.insert(primitiveData.end(), primitive.center, primitive.center + 3);
+        primitiveData.push_back((float)(primitive.type | (primitive.hiddenFromCamera ? 2 : 0)));
+
+        primitiveData.insert(primitiveData.end(), primitive.size, primitive.size + 3);
+        primitiveData.push_back((float)primitive.material);
+    }
+
+    // [color, roughness] [specularColor, specularProbability] [emmisive, 0]
+    std::vector<float> materialData;
+    materialData.reserve(scene.materials.size() * 12 + 12);
+
+    for (const PrimitiveMaterial &material : scene.materials) {
+
+        materialData.insert(materialData.end(), material.color, material.color + 3);
+        materialData.push_back(material.roughness);
+
+        materialData.insert(materialData.end(), material.specularColor, material.specularColor + 3);
+        materialData.push_back(material.specularProbability);
+
+        materialData.insert(materialData.end(), material.emmisive, material.emmisive + 3);
+        materialData.push_back(0.0f);
+    }
+
+    // Empty buffers aren't allowed, keep a blank texel
+    primitiveData.resize(std::max<size_t>(primitiveData.size(), 4));
+    materialData.resize(std::max<size_t>(materialData.size(), 4));
+
+    primitives.update(primitiveData.data(), primitiveData.size() * sizeof(float));
+    materials.update(materialData.data(), materialData.size() * sizeof(float));
+}
+
+void SceneTextures::bindSamplers(Program &program) {
+
+    program.bindSampler("u_bvhNodes", BVH_NODES_UNIT, GL_TEXTURE_BUFFER, nodes.getTexture());
+    program.bindSampler("u_primitives", BVH_PRIMITIVES_UNIT, GL_TEXTURE_BUFFER, primitives.getTexture());
+    program.bindSampler("u_materials", BVH_MATERIALS_UNIT, GL_TEXTURE_BUFFER, materials.getTexture());
+}
+
+void SceneTextures::kill() {
+    nodes.kill();
+    primitives.kill();
+    materials.kill();
+}
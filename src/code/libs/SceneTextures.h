@@ -0,0 +1,41 @@
+#pragma once
+
+#include "./TextureBuffer.h"
+#include "./PrimitiveScene.h"
+#include "./Bvh.h"
+#include "./Program.h"
+
+// Texture units for common/bvh.glsl's samplers (unit 0 is the accumulation history)
+const GLuint BVH_NODES_UNIT = 1;
+const GLuint BVH_PRIMITIVES_UNIT = 2;
+const GLuint BVH_MATERIALS_UNIT = 3;
+
+// A PrimitiveScene and its BVH packed into texture buffers for common/bvh.glsl
+// GL 3.3 has no storage buffers and a uniform block can't hold thousands of primitives
+class SceneTextures {
+
+    private:
+
+        // 2 texels per node, 2 per primitive (in BVH order), 3 per material
+        TextureBuffer nodes;
+        TextureBuffer primitives;
+        TextureBuffer materials;
+
+    public:
+
+        // Constructor
+        // Creates the (empty) buffers
+        SceneTextures(bool create);
+
+        // Methods
+        // Packs the scene and its BVH and uploads them
+        void upload(const PrimitiveScene &scene, const Bvh &bvh);
+
+        // Points the program's samplers at our units, does nothing if it doesn't use them
+        void bindSamplers(Program &program);
+
+        // Frees the buffers
+        void kill();
+
+        SceneTextures() {};
+};
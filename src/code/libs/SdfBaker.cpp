@@ -0,0 +1,148 @@
+#include "SdfBaker.h"
+
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+
+// ------------------------------- Baking ---------------------------------------
+
+
+std::vector<uint16_t> bakeSdf(const SdfScene &scene, const SdfBakeSettings &settings) {
+
+    const int width = settings.resolution[0];
+    const int height = settings.resolution[1];
+    const int depth = settings.resolution[2];
+
+    std::vector<uint16_t> voxels((size_t)width * height * depth);
+
+    // Size of one voxel
+    float step[3];
+    for (int i = 0; i < 3; i++) {
+        step[i] = (settings.boundsMax[i] - settings.boundsMin[i]) / settings.resolution[i];
+    }
+
+    // Slices are handed out one at a time so uneven scenes still split evenly
+    std::atomic<int> nextSlice(0);
+
+    auto work = [&]() {
+
+        int z;
+        while ((z = nextSlice.fetch_add(1)) < depth) {
+
+            float position[3];
+
+            // Voxel centers, where a linear sampler reads the texel exactly
+            position[2] = settings.boundsMin[2] + (z + 0.5f) * step[2];
+
+            for (int y = 0; y < height; y++) {
+
+                position[1] = settings.boundsMin[1] + (y + 0.5f) * step[1];
+                uint16_t* row = &voxels[((size_t)z * height + y) * width];
+
+                for (int x = 0; x < width; x++) {
+                    position[0] = settings.boundsMin[0] + (x + 0.5f) * step[0];
+                    row[x] = floatToHalf(scene.evaluate(position));
+                }
+            }
+        }
+    };
+
+    int threadCount = settings.threads;
+
+    // hardware_concurrency can't always tell
+    if (threadCount <= 0) {
+        threadCount = (int)std::thread::hardware_concurrency();
+    }
+    if (threadCount <= 0) {
+        threadCount = 4;
+    }
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threadCount; i++) {
+        workers.push_back(std::thread(work));
+    }
+
+    // This thread helps too
+    work();
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    return voxels;
+}
+
+void fitSdfBounds(const SdfScene &scene, float margin, int resolution, SdfBakeSettings &settings) {
+
+    scene.getBounds(settings.boundsMin, settings.boundsMax);
+
+    float longest = 0.0f;
+
+    for (int i = 0; i < 3; i++) {
+        settings.boundsMin[i] -= margin;
+        settings.boundsMax[i] += margin;
+        longest = std::max(longest, settings.boundsMax[i] - settings.boundsMin[i]);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        float extent = settings.boundsMax[i] - settings.boundsMin[i];
+        settings.resolution[i] = std::max(2, (int)std::ceil(resolution * extent / longest));
+    }
+}
+
+
+// ------------------------------ Half floats ------------------------------------
+
+
+uint16_t floatToHalf(float value) {
+
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // NaN stays NaN, infinity and anything too big saturate to infinity
+    if (((bits >> 23) & 0xFF) == 0xFF) {
+        return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    }
+    if (exponent >= 31) {
+        return (uint16_t)(sign | 0x7C00);
+    }
+
+    // Too small for a normal half, shift it into a denormal (or zero)
+    if (exponent <= 0) {
+
+        if (exponent < -10) {
+            return (uint16_t)sign;
+        }
+
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+
+        // Round to nearest even
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            half++;
+        }
+
+        return (uint16_t)(sign | half);
+    }
+
+    uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+
+    // Round to nearest even, carrying into the exponent is still correct
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        half++;
+    }
+
+    return (uint16_t)(sign | half);
+}
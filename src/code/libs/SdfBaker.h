@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "./SdfScene.h"
+
+// What to bake: a grid of distances over a box
+struct SdfBakeSettings {
+    int resolution[3] = { 64, 64, 64 }; // Voxels along each axis
+    float boundsMin[3] = { -1.0f, -1.0f, -1.0f };
+    float boundsMax[3] = { 1.0f, 1.0f, 1.0f };
+    int threads = 0; // 0 uses every core
+};
+
+// Evaluates the scene at every voxel's center, split over threads by z slice
+// Returns half floats (x fastest, then y, then z) ready for an R16F 3D texture
+std::vector<uint16_t> bakeSdf(const SdfScene &scene, const SdfBakeSettings &settings);
+
+// Bounds that fit the scene with a margin on every side, so the surface never touches the edge
+// Resolution is the voxel count along the longest side, the others are set so voxels stay cubes
+void fitSdfBounds(const SdfScene &scene, float margin, int resolution, SdfBakeSettings &settings);
+
+// IEEE half float, rounded to nearest
+uint16_t floatToHalf(float value);
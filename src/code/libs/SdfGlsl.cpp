@@ -0,0 +1,248 @@
+#include "SdfGlsl.h"
+
+#include <sstream>
+#include <algorithm>
+
+
+// Unions of at most this many shapes aren't grouped any further
+const int SDF_GROUP_LEAF = 2;
+
+// Bounds are padded a little so the rounding when they're printed never culls a shape that counts
+const float SDF_BOUND_PADDING = 0.001f;
+
+
+// ------------------------------- Helpers ---------------------------------------
+
+
+// A float GLSL reads as a float ("1" would be an int)
+static std::string glslFloat(float value) {
+
+    std::ostringstream stream;
+    stream.precision(7);
+    stream << value;
+
+    std::string text = stream.str();
+
+    if (text.find_first_of(".e") == std::string::npos) {
+        text += ".0";
+    }
+
+    return text;
+}
+
+static std::string glslVec3(const float value[3]) {
+    return "vec3(" + glslFloat(value[0]) + ", " + glslFloat(value[1]) + ", " + glslFloat(value[2]) + ")";
+}
+
+// The distance to a bound, written the way circleSDF would
+static std::string boundDistance(const SdfBound &bound) {
+    return "circleSDF(position - " + glslVec3(bound.center) + ", " + glslFloat(bound.radius + SDF_BOUND_PADDING) + ")";
+}
+
+// The call for one shape, plain or with its gradient
+static std::string shapeCall(const SdfShape &shape, bool gradient) {
+
+    std::string suffix = gradient ? "Gradient(" : "(";
+    std::string position = "position - " + glslVec3(shape.center);
+
+    switch (shape.type) {
+        case SDF_SPHERE: return "circleSDF" + suffix + position + ", " + glslFloat(shape.size[0]) + ")";
+        case SDF_BOX: return "sdBox" + suffix + position + ", " + glslVec3(shape.size) + ")";
+        case SDF_CAPPED_CYLINDER: return "sdCappedCylinder" + suffix + position + ", " + glslFloat(shape.size[0]) + ", " + glslFloat(shape.size[1]) + ")";
+    }
+
+    return gradient ? "vec4(1e10, 0.0, 0.0, 0.0)" : "1e10";
+}
+
+
+// ------------------------------- Writing ---------------------------------------
+
+
+// Everything one function is written with
+struct SdfWriter {
+    const SdfScene &scene;
+    bool gradient; // mapGradient() instead of map()
+    std::ostringstream code;
+    bool folded = false; // Distance holds a shape, before that nothing can be culled
+
+    SdfWriter(const SdfScene &scene, bool gradient) : scene(scene), gradient(gradient) {};
+
+    // The distance so far as a float
+    std::string distance() {
+        return gradient ? "distance.x" : "distance";
+    }
+
+    void indent(int depth) {
+        code << std::string(depth * 4, ' ');
+    }
+
+    // Opens a block that's only run while the bound could matter
+    // Condition is the bound's distance compared with the distance so far
+    void openCulled(int depth, const std::string &condition) {
+        indent(depth);
+        code << "if (SDF_CULLING == 0 || " << condition << ") {\n";
+    }
+
+    void close(int depth) {
+        indent(depth);
+        code << "}\n";
+    }
+
+    // One shape folded in with its own operation
+    void writeShape(int index, int depth) {
+
+        const SdfShape &shape = scene.shapes[index];
+        std::string call = shapeCall(shape, gradient);
+
+        std::string bound = boundDistance(scene.getBoundingSphere(index));
+        std::string condition;
+        std::string fold;
+
+        switch (shape.operation) {
+
+            // min only changes where the shape is closer
+            case SDF_UNION:
+                condition = bound + " < " + distance();
+                fold = gradient ? "unionGradient(distance, " + call + ")" : "min(distance, " + call + ")";
+                break;
+
+            // max(d, -s) only changes where the shape is deeper than -d
+            case SDF_SUBTRACT:
+                condition = bound + " < -" + distance();
+                fold = gradient ? "subtractGradient(distance, " + call + ")" : "max(distance, -" + call + ")";
+                break;
+
+            // Changes the distance everywhere outside the shape, never culled
+            case SDF_INTERSECT:
+                fold = gradient ? "intersectGradient(distance, " + call + ")" : "max(distance, " + call + ")";
+                break;
+
+            // The blend reaches smoothness further out than the shape
+            case SDF_SMOOTH_UNION:
+                condition = bound + " < " + distance() + " + " + glslFloat(shape.smoothness);
+                fold = (gradient ? "sminGradient(distance, " : "smin(distance, ") + call + ", " + glslFloat(shape.smoothness) + ")";
+                break;
+        }
+
+        // A sphere's bound is the sphere, testing it costs as much as folding it in
+        bool culled = folded && !condition.empty() && shape.type != SDF_SPHERE;
+
+        // The first shape added is the distance as it is
+        bool adds = shape.operation == SDF_UNION || shape.operation == SDF_SMOOTH_UNION;
+
+        if (culled) {
+            openCulled(depth, condition);
+        }
+
+        indent(depth + (culled ? 1 : 0));
+        code << "distance = " << (folded || !adds ? fold : call) << ";\n";
+
+        if (culled) {
+            close(depth);
+        }
+
+        folded |= adds;
+    }
+
+    // Unioned shapes can go in any order, so they're split into nested groups by where they are
+    // A group far away is skipped with one test instead of one per shape
+    void writeUnion(std::vector<int> group, int depth) {
+
+        if ((int)group.size() <= SDF_GROUP_LEAF) {
+            for (int shape : group) {
+                writeShape(shape, depth);
+            }
+            return;
+        }
+
+        // Split at the median along the widest axis of the centers
+        float min[3];
+        float max[3];
+
+        for (int i = 0; i < (int)group.size(); i++) {
+            const float* center = scene.shapes[group[i]].center;
+
+            for (int k = 0; k < 3; k++) {
+                min[k] = i == 0 ? center[k] : std::min(min[k], center[k]);
+                max[k] = i == 0 ? center[k] : std::max(max[k], center[k]);
+            }
+        }
+
+        int axis = 0;
+        for (int k = 1; k < 3; k++) {
+            if (max[k] - min[k] > max[axis] - min[axis]) {
+                axis = k;
+            }
+        }
+
+        std::sort(group.begin(), group.end(), [&](int a, int b) {
+            return scene.shapes[a].center[axis] < scene.shapes[b].center[axis];
+        });
+
+        std::vector<int> left(group.begin(), group.begin() + group.size() / 2);
+        std::vector<int> right(group.begin() + group.size() / 2, group.end());
+
+        // Nothing to compare with yet, the first group is always needed
+        bool culled = folded;
+
+        if (culled) {
+            indent(depth);
+            code << "// " << group.size() << " shapes\n";
+            openCulled(depth, boundDistance(scene.getBoundingSphere(group)) + " < " + distance());
+        }
+
+        writeUnion(left, depth + (culled ? 1 : 0));
+        writeUnion(right, depth + (culled ? 1 : 0));
+
+        if (culled) {
+            close(depth);
+        }
+    }
+
+    // The whole function
+    void write() {
+
+        code << (gradient ? "vec4 mapGradient(vec3 position) {\n\n" : "float map(vec3 position) {\n\n");
+        code << (gradient ? "    vec4 distance = vec4(1e10, 0.0, 0.0, 0.0);\n\n" : "    float distance = 1e10;\n\n");
+
+        // Runs of unions are grouped, everything else is folded in the order it was added
+        std::vector<int> run;
+
+        for (int i = 0; i <= (int)scene.shapes.size(); i++) {
+
+            if (i < (int)scene.shapes.size() && scene.shapes[i].operation == SDF_UNION) {
+                run.push_back(i);
+                continue;
+            }
+
+            if (!run.empty()) {
+                writeUnion(run, 1);
+                run.clear();
+            }
+
+            if (i < (int)scene.shapes.size()) {
+                writeShape(i, 1);
+            }
+        }
+
+        code << "\n    return distance;\n}\n";
+    }
+};
+
+std::string generateSdfGlsl(const SdfScene &scene) {
+
+    std::ostringstream code;
+
+    code << "// Generated by generateSdfGlsl() from " << scene.shapes.size() << " shapes, edit the SdfScene instead\n\n";
+    code << "#ifndef SDF_CULLING\n#define SDF_CULLING 1\n#endif\n\n";
+
+    SdfWriter map(scene, false);
+    map.write();
+
+    SdfWriter mapGradient(scene, true);
+    mapGradient.write();
+
+    code << map.code.str() << "\n" << mapGradient.code.str();
+
+    return code.str();
+}
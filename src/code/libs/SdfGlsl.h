@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+#include "./SdfScene.h"
+
+// GLSL for a scene's map() and mapGradient(), served to shaders with Shader::setVirtualFile
+// Needs common/sdf.glsl included before it
+//
+// Each shape (and each group of unioned shapes) is skipped while its bounding sphere is further away
+// than the distance so far, the skipped shapes could never have changed it. SDF_CULLING 0 turns that off
+std::string generateSdfGlsl(const SdfScene &scene);
@@ -0,0 +1,246 @@
+#include "SdfScene.h"
+
+#include <cmath>
+#include <algorithm>
+#include <random>
+
+
+// ------------------------------ Shapes ----------------------------------------
+
+
+void SdfScene::addSphere(float x, float y, float z, float radius, int operation, float smoothness) {
+    shapes.push_back({ SDF_SPHERE, operation, { x, y, z }, { radius, radius, radius }, smoothness });
+}
+
+void SdfScene::addBox(float x, float y, float z, float halfX, float halfY, float halfZ, int operation, float smoothness) {
+    shapes.push_back({ SDF_BOX, operation, { x, y, z }, { halfX, halfY, halfZ }, smoothness });
+}
+
+void SdfScene::addCappedCylinder(float x, float y, float z, float halfHeight, float radius, int operation, float smoothness) {
+    shapes.push_back({ SDF_CAPPED_CYLINDER, operation, { x, y, z }, { halfHeight, radius, 0.0f }, smoothness });
+}
+
+
+// --------------------------- Distance functions --------------------------------
+
+
+// common/sdf.glsl's smin
+static float smoothMin(float a, float b, float k) {
+    float h = std::max(k - std::fabs(a - b), 0.0f) / k;
+    return std::min(a, b) - h * h * h * k * (1.0f / 6.0f);
+}
+
+float evaluateSdfShape(const SdfShape &shape, const float position[3]) {
+
+    float p[3] = {
+        position[0] - shape.center[0],
+        position[1] - shape.center[1],
+        position[2] - shape.center[2]
+    };
+
+    switch (shape.type) {
+
+        // length(p) - r
+        case SDF_SPHERE:
+            return std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]) - shape.size[0];
+
+        // length(max(q, 0)) + min(max(q.x, q.y, q.z), 0)
+        case SDF_BOX: {
+            float q[3];
+            float outside = 0.0f;
+
+            for (int i = 0; i < 3; i++) {
+                q[i] = std::fabs(p[i]) - shape.size[i];
+                outside += std::max(q[i], 0.0f) * std::max(q[i], 0.0f);
+            }
+
+            return std::sqrt(outside) + std::min(std::max(q[0], std::max(q[1], q[2])), 0.0f);
+        }
+
+        // Radius around y, half height along it
+        case SDF_CAPPED_CYLINDER: {
+            float dx = std::sqrt(p[0] * p[0] + p[2] * p[2]) - shape.size[1];
+            float dy = std::fabs(p[1]) - shape.size[0];
+
+            float outsideX = std::max(dx, 0.0f);
+            float outsideY = std::max(dy, 0.0f);
+
+            return std::min(std::max(dx, dy), 0.0f) + std::sqrt(outsideX * outsideX + outsideY * outsideY);
+        }
+    }
+
+    return 1e10f;
+}
+
+float SdfScene::evaluate(const float position[3]) const {
+
+    // Nothing is infinitely far away
+    float distance = 1e10f;
+
+    for (const SdfShape &shape : shapes) {
+
+        float shapeDistance = evaluateSdfShape(shape, position);
+
+        switch (shape.operation) {
+            case SDF_UNION: distance = std::min(distance, shapeDistance); break;
+            case SDF_SUBTRACT: distance = std::max(distance, -shapeDistance); break;
+            case SDF_INTERSECT: distance = std::max(distance, shapeDistance); break;
+            case SDF_SMOOTH_UNION: distance = smoothMin(distance, shapeDistance, shape.smoothness); break;
+        }
+    }
+
+    return distance;
+}
+
+
+// -------------------------------- Bounds ---------------------------------------
+
+
+void SdfScene::getBounds(int shape, float min[3], float max[3]) const {
+
+    const SdfShape &current = shapes[shape];
+
+    // The cylinder stands on y
+    float extent[3] = { current.size[0], current.size[1], current.size[2] };
+
+    if (current.type == SDF_CAPPED_CYLINDER) {
+        extent[0] = current.size[1];
+        extent[1] = current.size[0];
+        extent[2] = current.size[1];
+    }
+
+    for (int i = 0; i < 3; i++) {
+        min[i] = current.center[i] - extent[i];
+        max[i] = current.center[i] + extent[i];
+    }
+}
+
+void SdfScene::getBounds(float min[3], float max[3]) const {
+
+    bool empty = true;
+
+    for (int i = 0; i < (int)shapes.size(); i++) {
+
+        // Only these add to the surface
+        if (shapes[i].operation != SDF_UNION && shapes[i].operation != SDF_SMOOTH_UNION) {
+            continue;
+        }
+
+        float shapeMin[3];
+        float shapeMax[3];
+        getBounds(i, shapeMin, shapeMax);
+
+        // smin bulges out by at most k / 6
+        float bulge = shapes[i].operation == SDF_SMOOTH_UNION ? shapes[i].smoothness / 6.0f : 0.0f;
+
+        for (int k = 0; k < 3; k++) {
+            min[k] = empty ? shapeMin[k] - bulge : std::min(min[k], shapeMin[k] - bulge);
+            max[k] = empty ? shapeMax[k] + bulge : std::max(max[k], shapeMax[k] + bulge);
+        }
+
+        empty = false;
+    }
+
+    if (empty) {
+        for (int k = 0; k < 3; k++) {
+            min[k] = 0.0f;
+            max[k] = 0.0f;
+        }
+    }
+}
+
+SdfBound SdfScene::getBoundingSphere(int shape) const {
+
+    const SdfShape &current = shapes[shape];
+
+    SdfBound bound = { { current.center[0], current.center[1], current.center[2] }, current.size[0] };
+
+    // Out to the corners
+    if (current.type == SDF_BOX) {
+        bound.radius = std::sqrt(current.size[0] * current.size[0] + current.size[1] * current.size[1] + current.size[2] * current.size[2]);
+    }
+
+    // Out to the rims of the caps
+    else if (current.type == SDF_CAPPED_CYLINDER) {
+        bound.radius = std::sqrt(current.size[0] * current.size[0] + current.size[1] * current.size[1]);
+    }
+
+    return bound;
+}
+
+SdfBound SdfScene::getBoundingSphere(const std::vector<int> &group) const {
+
+    // Centered on the box around the group
+    float min[3];
+    float max[3];
+
+    for (int i = 0; i < (int)group.size(); i++) {
+
+        float shapeMin[3];
+        float shapeMax[3];
+        getBounds(group[i], shapeMin, shapeMax);
+
+        for (int k = 0; k < 3; k++) {
+            min[k] = i == 0 ? shapeMin[k] : std::min(min[k], shapeMin[k]);
+            max[k] = i == 0 ? shapeMax[k] : std::max(max[k], shapeMax[k]);
+        }
+    }
+
+    SdfBound bound = { { (min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f, (min[2] + max[2]) * 0.5f }, 0.0f };
+
+    // Big enough for every shape's own sphere
+    for (int shape : group) {
+
+        SdfBound shapeBound = getBoundingSphere(shape);
+
+        float dx = shapeBound.center[0] - bound.center[0];
+        float dy = shapeBound.center[1] - bound.center[1];
+        float dz = shapeBound.center[2] - bound.center[2];
+
+        bound.radius = std::max(bound.radius, std::sqrt(dx * dx + dy * dy + dz * dz) + shapeBound.radius);
+    }
+
+    return bound;
+}
+
+
+// ------------------------------- Scenes ----------------------------------------
+
+
+SdfScene createBetterShaderScene() {
+
+    SdfScene scene;
+
+    // max(pipeOne, -pipeTwo), an open tube
+    scene.addCappedCylinder(0.0f, 0.0f, 0.0f, 5.0f, 1.0f);
+    scene.addCappedCylinder(0.0f, 0.0f, 0.0f, 5.1f, 0.8f, SDF_SUBTRACT);
+
+    return scene;
+}
+
+void addRandomSdfShapes(SdfScene &scene, int count, unsigned int seed) {
+
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (int i = 0; i < count; i++) {
+
+        // Around the pipe, clear of its inside
+        float angle = unit(random) * 6.2831853f;
+        float distance = 1.5f + unit(random) * 3.0f;
+
+        float x = std::cos(angle) * distance;
+        float y = -5.0f + unit(random) * 10.0f;
+        float z = std::sin(angle) * distance;
+
+        float size = 0.1f + unit(random) * 0.3f;
+
+        if (unit(random) < 0.5f) {
+            scene.addSphere(x, y, z, size);
+        }
+
+        else {
+            scene.addBox(x, y, z, size, size, size);
+        }
+    }
+}
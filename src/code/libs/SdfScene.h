@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+
+// C++ side of betterShader.frag's map(): primitive distance functions folded together with CSG
+// Evaluated on the CPU by the SDF baker and written out as the shader's GLSL by generateSdfGlsl
+
+// Primitive types (the functions in common/sdf.glsl)
+const int SDF_SPHERE = 0; // circleSDF, radius in size[0]
+const int SDF_BOX = 1; // sdBox, half extents in size
+const int SDF_CAPPED_CYLINDER = 2; // sdCappedCylinder, half height in size[0] and radius in size[1]
+
+// How a shape is combined with everything before it
+const int SDF_UNION = 0; // min
+const int SDF_SUBTRACT = 1; // max(d, -shape)
+const int SDF_INTERSECT = 2; // max
+const int SDF_SMOOTH_UNION = 3; // smin with the shape's smoothness
+
+// One primitive and its operation
+struct SdfShape {
+    int type;
+    int operation;
+    float center[3];
+    float size[3];
+    float smoothness; // smin's k, only for SDF_SMOOTH_UNION
+};
+
+// A sphere that holds a shape (or a group of them), its distance is never more than theirs
+struct SdfBound {
+    float center[3];
+    float radius;
+};
+
+// The shapes in the order map() folds them
+struct SdfScene {
+    std::vector<SdfShape> shapes;
+
+    // Add shapes
+    void addSphere(float x, float y, float z, float radius, int operation = SDF_UNION, float smoothness = 0.0f);
+    void addBox(float x, float y, float z, float halfX, float halfY, float halfZ, int operation = SDF_UNION, float smoothness = 0.0f);
+    void addCappedCylinder(float x, float y, float z, float halfHeight, float radius, int operation = SDF_UNION, float smoothness = 0.0f);
+
+    // The distance at a point, like map()
+    float evaluate(const float position[3]) const;
+
+    // Min / max corners of a shape
+    void getBounds(int shape, float min[3], float max[3]) const;
+
+    // Box around everything that's added (subtracted and intersected shapes can only cut it down)
+    void getBounds(float min[3], float max[3]) const;
+
+    // Sphere around a shape
+    SdfBound getBoundingSphere(int shape) const;
+
+    // Sphere around a group of shapes
+    SdfBound getBoundingSphere(const std::vector<int> &group) const;
+};
+
+// Distance to a single shape, ignoring its operation
+float evaluateSdfShape(const SdfShape &shape, const float position[3]);
+
+// betterShader.frag's map(), the pipe
+SdfScene createBetterShaderScene();
+
+// Scatters small spheres and boxes around the pipe, same seed gives the same shapes
+void addRandomSdfShapes(SdfScene &scene, int count, unsigned int seed);
@@ -0,0 +1,85 @@
+#include "SdfVolume.h"
+
+#include <chrono>
+#include <cmath>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+SdfVolume::SdfVolume(bool create) {
+
+    if (!create) return;
+
+    glGenTextures(1, &texture);
+
+    glActiveTexture(GL_TEXTURE0 + SDF_VOLUME_UNIT);
+    glBindTexture(GL_TEXTURE_3D, texture);
+
+    // Clamped so samples past the edge read the border voxels instead of wrapping
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    // One far away voxel so the texture is never incomplete
+    uint16_t far = floatToHalf(1000.0f);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_R16F, 1, 1, 1, 0, GL_RED, GL_HALF_FLOAT, &far);
+
+    glActiveTexture(GL_TEXTURE0);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+float SdfVolume::bake(const SdfScene &scene, const SdfBakeSettings &settings) {
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<uint16_t> voxels = bakeSdf(scene, settings);
+
+    float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    upload(voxels, settings);
+
+    return ms;
+}
+
+void SdfVolume::upload(const std::vector<uint16_t> &voxels, const SdfBakeSettings &settings) {
+
+    this->settings = settings;
+
+    glActiveTexture(GL_TEXTURE0 + SDF_VOLUME_UNIT);
+    glBindTexture(GL_TEXTURE_3D, texture);
+
+    // Rows of half floats aren't always 4 byte aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_R16F, settings.resolution[0], settings.resolution[1], settings.resolution[2], 0, GL_RED, GL_HALF_FLOAT, voxels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glActiveTexture(GL_TEXTURE0);
+
+    baked = true;
+}
+
+void SdfVolume::bindSamplers(Program &program) {
+
+    program.bindSampler("u_sdfVolume", SDF_VOLUME_UNIT, GL_TEXTURE_3D, texture);
+    program.setArrayf3("u_sdfBoundsMin", settings.boundsMin);
+    program.setArrayf3("u_sdfBoundsMax", settings.boundsMax);
+
+    // Interpolating between voxels can be off by up to half a voxel's diagonal
+    float voxel[3];
+    for (int i = 0; i < 3; i++) {
+        voxel[i] = (settings.boundsMax[i] - settings.boundsMin[i]) / settings.resolution[i];
+    }
+
+    program.setFloat("u_sdfVoxelDiagonal", std::sqrt(voxel[0] * voxel[0] + voxel[1] * voxel[1] + voxel[2] * voxel[2]));
+}
+
+void SdfVolume::kill() {
+    glDeleteTextures(1, &texture);
+    baked = false;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+#include <vector>
+#include <cstdint>
+
+#include "./SdfBaker.h"
+#include "./Program.h"
+
+// Texture unit for the baked volume (0 is the accumulation history, 1 - 3 the BVH)
+const GLuint SDF_VOLUME_UNIT = 4;
+
+// A baked SDF in an R16F 3D texture, read by shaders built with BAKED_SDF
+// Linear filtering gives a smooth distance between voxel centers
+class SdfVolume {
+
+    private:
+
+        GLuint texture;
+
+        // What the texture covers
+        SdfBakeSettings settings;
+
+        // Nothing baked yet
+        bool baked = false;
+
+    public:
+
+        // Constructor
+        // Makes the (empty) texture, nothing is sampled until bake or upload fills it
+        SdfVolume(bool create);
+
+        // Getters
+        bool isBaked() { return baked; };
+        const SdfBakeSettings& getSettings() { return settings; };
+
+        // Methods
+        // Bakes the scene on every core and uploads it, returns how long the bake took in ms
+        float bake(const SdfScene &scene, const SdfBakeSettings &settings);
+
+        // Uploads voxels that were already baked (from bakeSdf)
+        void upload(const std::vector<uint16_t> &voxels, const SdfBakeSettings &settings);
+
+        // Sets the program's sampler and bounds uniforms, does nothing if it doesn't use them
+        void bindSamplers(Program &program);
+
+        // Frees the texture
+        void kill();
+
+        SdfVolume() {};
+};
@@ -2,8 +2,19 @@
 #include "../../includes/packs/fileImports.h"
 
 #include "Shader.h"
+#include "GLExtensions.h"
 #include <filesystem>
 #include <cstring>
+#include <regex>
+#include <algorithm>
+
+
+// The shared source cache
+unordered_map<string, Shader::SourceFile> Shader::sourceCache;
+mutex Shader::sourceCacheMutex;
+
+// Marks the file table at the end of a preprocessed shader ("// @file 1 path")
+static const string FILE_TABLE_MARKER = "// @file ";
 
 
 // ------------------------- Constructor(s) ------------------------------------
@@ -14,77 +25,430 @@
 Shader::Shader(const char* shaderPath, GLint openGlShader) {
 
     // Compiling our shader and setting it to the attribute
-    this->shader = compileShader(shaderPath, openGlShader);
+    this->shader = compileShader(readSource(shaderPath), openGlShader);
+
+}
+
+// Shader Path - file path to shader
+// Open Gl Shader - type of shader ex. (GL_VERTEX_SHADER / GL_FRAGMENT_SHADER)
+// Defines - compile time settings the shader checks with #ifndef
+Shader::Shader(const char* shaderPath, GLint openGlShader, const ShaderDefines &defines) {
+
+    // Compiling our specialized shader and setting it to the attribute
+    this->shader = compileShader(readSource(shaderPath, defines), openGlShader);
+
+}
+
+// Source - the shader's code
+// Open Gl Shader - type of shader ex. (GL_VERTEX_SHADER / GL_FRAGMENT_SHADER)
+Shader Shader::fromSource(const string &source, GLint openGlShader) {
+
+    Shader shader;
+
+    // Compiling our shader and setting it to the attribute
+    shader.shader = shader.compileShader(source, openGlShader);
 
+    return shader;
+}
+
+// Source - the shader's code
+// Open Gl Shader - type of shader ex. (GL_VERTEX_SHADER / GL_FRAGMENT_SHADER)
+Shader Shader::submit(const string &source, GLint openGlShader) {
+
+    Shader shader;
+
+    // Only queued, the driver might still be compiling it on its own threads
+    shader.shader = shader.submitShader(source, openGlShader);
+
+    return shader;
 }
 
 
 // ------------------------------- Methods --------------------------------------
 
-// Compiling our final shader
+// Reading a shader file with its includes
 // Shader Path - file path to shader
-// Open Gl Shader - type of shader ex. (GL_VERTEX_SHADER / GL_FRAGMENT_SHADER)
-GLint Shader::compileShader(const char* shaderPath, GLint openGlShader) {
+string Shader::readSource(const char* shaderPath) {
+    vector<string> dependencies;
+    return readSource(shaderPath, dependencies);
+}
 
-    // File variable
-    ifstream file;
+// Reading a shader file with its includes
+// Shader Path - file path to shader
+// Dependencies - filled with every file used, the shader itself first
+string Shader::readSource(const char* shaderPath, vector<string> &dependencies) {
+
+    lock_guard<mutex> lock(sourceCacheMutex);
+
+    string path = filesystem::path(shaderPath).lexically_normal().string();
+
+    dependencies.clear();
+    dependencies.push_back(path);
+
+    // Missing files give an empty shader (which then fails to compile)
+    if (loadSourceFile(path) == NULL) {
+        return "";
+    }
+
+    // Expand everything
+    string output;
+    expandSource(path, 0, output, dependencies);
+
+    // Add the file table so errors can be mapped back to paths
+    // It's at the end so it doesn't move any line numbers or come before #version
+    for (size_t i = 0; i < dependencies.size(); i++) {
+        output += FILE_TABLE_MARKER + to_string(i) + " " + dependencies[i] + "\n";
+    }
+
+    return output;
+}
+
+// Reading a shader file with its includes and defines
+// Shader Path - file path to shader
+// Defines - compile time settings to inject
+string Shader::readSource(const char* shaderPath, const ShaderDefines &defines) {
+    return injectDefines(readSource(shaderPath), defines);
+}
+
+// Add the defines after #version
+// Source - the preprocessed code
+// Defines - what to add
+string Shader::injectDefines(const string &source, const ShaderDefines &defines) {
+
+    // Nothing to do
+    if (defines.empty()) {
+        return source;
+    }
+
+    string injected;
+    for (const pair<string, string> &define : defines) {
+        injected += "#define " + define.first + " " + define.second + "\n";
+    }
+
+    // #version has to stay first, so go right after it
+    size_t version = source.find("#version");
+
+    if (version == string::npos) {
+        return injected + "#line 1 0\n" + source;
+    }
+
+    size_t lineEnd = source.find('\n', version);
 
-    // Set some exeptions to our file
-    file.exceptions(ifstream::failbit | ifstream::badbit);
+    if (lineEnd == string::npos) {
+        return source + "\n" + injected;
+    }
+
+    // Count the lines up to there so the numbering picks up where it left off
+    int line = 1;
+    for (size_t i = 0; i <= lineEnd; i++) {
+        if (source[i] == '\n') { line++; }
+    }
+
+    return source.substr(0, lineEnd + 1) + injected + "#line " + to_string(line) + " 0\n" + source.substr(lineEnd + 1);
+}
 
-    // Open our file 
-    file.open(shaderPath);
+// A stable name for a set of defines
+// Defines - the set
+string Shader::definesKey(const ShaderDefines &defines) {
+
+    // Order doesn't change what the shader sees, so sort it away
+    ShaderDefines sorted = defines;
+    sort(sorted.begin(), sorted.end());
+
+    string key;
+    for (const pair<string, string> &define : sorted) {
+        key += define.first + "=" + define.second + ";";
+    }
+
+    return key;
+}
+
+// Just the files
+vector<string> Shader::getDependencies(const char* shaderPath) {
+    vector<string> dependencies;
+    readSource(shaderPath, dependencies);
+    return dependencies;
+}
+
+// Generated code as a file
+// Path - where shaders include it from
+// Code - the file's contents
+void Shader::setVirtualFile(const string &path, const string &code) {
+
+    lock_guard<mutex> lock(sourceCacheMutex);
+
+    string normalized = filesystem::path(path).lexically_normal().string();
+
+    SourceFile source;
+    source.inMemory = true;
+
+    stringstream input(code);
+    parseSource(input, normalized, source);
+
+    sourceCache[normalized] = source;
+}
+
+// Split a file into lines
+// Input - the code
+// Path - the file's path, includes are relative to it
+// Source - gets the lines and includes
+void Shader::parseSource(istream &input, const string &path, SourceFile &source) {
+
+    // Where includes are relative to
+    filesystem::path directory = filesystem::path(path).parent_path();
+
+    // Split it into lines and find the includes
+    string line;
+    while (getline(input, line)) {
+
+        // Look for #include "file"
+        size_t start = line.find_first_not_of(" \t");
+
+        if (start != string::npos && line.compare(start, 8, "#include") == 0) {
+
+            size_t open = line.find('"', start + 8);
+            size_t close = (open == string::npos) ? string::npos : line.find('"', open + 1);
+
+            if (close != string::npos) {
+                source.includeLines.push_back((int)source.lines.size());
+                source.includePaths.push_back((directory / line.substr(open + 1, close - open - 1)).lexically_normal().string());
+            }
+        }
+
+        source.lines.push_back(line);
+    }
+}
+
+// Get a file from the cache
+// Path - the file's path
+const Shader::SourceFile* Shader::loadSourceFile(const string &path) {
+
+    unordered_map<string, SourceFile>::iterator cached = sourceCache.find(path);
+
+    // Generated files don't exist on the disk
+    if (cached != sourceCache.end() && cached->second.inMemory) {
+        return &cached->second;
+    }
+
+    // When was it last changed
+    error_code error;
+    filesystem::file_time_type modified = filesystem::last_write_time(path, error);
+
+    if (error) {
+        cerr << "Failed to open the file " << path << endl;
+        return NULL;
+    }
+
+    // Still up to date
+    if (cached != sourceCache.end() && cached->second.modified == modified) {
+        return &cached->second;
+    }
+
+    // File variable
+    ifstream file(path);
 
     // Check for errors when opening
     if (!file.is_open()) {
-        cerr << "Failed to open the file." << endl;
-        return 1;
+        cerr << "Failed to open the file " << path << endl;
+        return NULL;
     }
 
-    // Get a buffer for our file text
-    stringstream buffer;
+    SourceFile source;
+    source.modified = modified;
 
-    // Get the text from the file and output it into the buffer
-    buffer << file.rdbuf();
+    parseSource(file, path, source);
 
-    // Close our file
-    file.close();
+    sourceCache[path] = source;
+    return &sourceCache[path];
+}
 
-    // Get the file contents from the buffer and put it into a string
-    string fileContents = buffer.str();
+// Expand a file's includes into output
+// Path - the file to write
+// File Number - its number in the #line directives
+// Output - the finished code
+// Files - every file written so far, each one is only included once
+void Shader::expandSource(const string &path, int fileNumber, string &output, vector<string> &files) {
 
-    // Save the file contents into a const char*
-    const char* fileContentsChar = fileContents.c_str();
+    const SourceFile* source = loadSourceFile(path);
+
+    if (source == NULL) {
+        return;
+    }
+
+    size_t nextInclude = 0;
+
+    // Loop every line
+    for (int i = 0; i < (int)source->lines.size(); i++) {
+
+        // Normal line
+        if (nextInclude >= source->includeLines.size() || source->includeLines[nextInclude] != i) {
+            output += source->lines[i] + "\n";
+            continue;
+        }
+
+        string includePath = source->includePaths[nextInclude];
+        nextInclude++;
+
+        // Already included, keep the line so the numbers don't move
+        bool included = false;
+        for (const string &file : files) {
+            if (file == includePath) { included = true; }
+        }
+
+        if (included) {
+            output += "\n";
+            continue;
+        }
+
+        // Missing, let the compiler report it on the right line
+        // It's still a dependency so the watcher rebuilds once the file is created
+        if (loadSourceFile(includePath) == NULL) {
+            files.push_back(includePath);
+            output += "#error missing include " + includePath + "\n";
+            continue;
+        }
+
+        // Write the included file with its own numbering
+        int includeNumber = (int)files.size();
+        files.push_back(includePath);
+
+        output += "#line 1 " + to_string(includeNumber) + "\n";
+        expandSource(includePath, includeNumber, output, files);
+
+        // Then go back to this file's numbering (the next line is i + 2 counting from 1)
+        output += "#line " + to_string(i + 2) + " " + to_string(fileNumber) + "\n";
+    }
+}
+
+// Turn "1:23(4): error" / "1(23) : error" / "ERROR: 1:23:" into "common/x.glsl:23"
+// Log - the compiler's log
+// Source - the preprocessed code with its file table
+string Shader::mapErrorLog(const string &log, const string &source) {
+
+    // Read the file table
+    vector<string> files;
+    size_t position = source.find(FILE_TABLE_MARKER);
+
+    while (position != string::npos) {
+        size_t end = source.find('\n', position);
+        string entry = source.substr(position + FILE_TABLE_MARKER.size(), end - position - FILE_TABLE_MARKER.size());
+        files.push_back(entry.substr(entry.find(' ') + 1));
+        position = source.find(FILE_TABLE_MARKER, end);
+    }
+
+    // No table means nothing to map
+    if (files.empty()) {
+        return log;
+    }
+
+    // The common formats, file number then line number
+    regex location("^((?:ERROR|WARNING): )?(\\d+)[:(](\\d+)\\)?");
+
+    stringstream input(log);
+    string output;
+    string line;
+
+    while (getline(input, line)) {
+
+        smatch match;
+
+        if (regex_search(line, match, location)) {
+
+            size_t fileNumber = stoul(match[2].str());
+
+            if (fileNumber < files.size()) {
+                line = match[1].str() + files[fileNumber] + ":" + match[3].str() + match.suffix().str();
+            }
+        }
+
+        output += line + "\n";
+    }
+
+    return output;
+}
+
+// Compiling our final shader
+// Source - the shader's code
+// Open Gl Shader - type of shader ex. (GL_VERTEX_SHADER / GL_FRAGMENT_SHADER)
+GLint Shader::compileShader(const string &source, GLint openGlShader) {
+
+    // Compile it and wait for the result
+    this->shader = submitShader(source, openGlShader);
+
+    if (!checkCompile()) {
+        return 1;
+    }
+
+    // Return the shader
+    return shader;
+}
+
+// Starting the compile
+// Source - the shader's code
+// Open Gl Shader - type of shader ex. (GL_VERTEX_SHADER / GL_FRAGMENT_SHADER)
+GLint Shader::submitShader(const string &source, GLint openGlShader) {
 
     // Save the text to a variable
-    this->shaderText = fileContentsChar;
+    this->shaderText = source;
+
+    // Save the file contents into a const char*
+    const char* fileContentsChar = shaderText.c_str();
 
     openGlShader = glCreateShader(openGlShader);
     
     // Create a shader source for more info to the openGlShader before compilation
     glShaderSource(openGlShader, 1, &fileContentsChar, NULL);
     
-    // Finally compile our shader
+    // Finally compile our shader (with KHR_parallel_shader_compile this returns before it's done)
     glCompileShader(openGlShader);
-    
 
-    // Error checking 
+    return openGlShader;
+}
+
+// Asking without blocking
+bool Shader::isComplete() {
+
+    // Without the extension the status query below is what waits
+    if (!GLExtensions::parallelShaderCompile) {
+        return true;
+    }
+
+    int complete = 0;
+    glGetShaderiv(shader, GL_COMPLETION_STATUS_KHR, &complete);
+
+    return complete;
+}
+
+// Error checking the compile
+bool Shader::checkCompile() {
+
+    // Already known
+    if (checked) {
+        return compiled;
+    }
+
+    checked = true;
+
     // Variables
     int success; // int to tell if an error has occored or not
-    char infoLog[512]; // The text output
 
-    // Get the shader iv to tell if an error happened or not
-    glGetShaderiv(openGlShader, GL_COMPILE_STATUS, &success); 
+    // Get the shader iv to tell if an error happened or not (this waits for the compile)
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success); 
 
     // Test for an error
     if(!success)
     {
-        // Get the error log
-        glGetShaderInfoLog(openGlShader, 512, NULL, infoLog);
+        // Get the error log (it can be long once includes are involved)
+        int logLength = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
 
-        // Output it
-        std::cout << "Shader Compilation Failed\n" << infoLog << std::endl;
-        return 1;
+        vector<char> infoLog(logLength + 1);
+        glGetShaderInfoLog(shader, logLength, NULL, infoLog.data());
+
+        // Output it with the real file names
+        std::cout << "Shader Compilation Failed\n" << mapErrorLog(infoLog.data(), shaderText) << std::endl;
+        compiled = false;
+        return false;
     }
 
     // No error
@@ -93,8 +457,8 @@ GLint Shader::compileShader(const char* shaderPath, GLint openGlShader) {
         std::cout << "Shader compiled sucsessfully" << std::endl;
     }
 
-    // Return the shader
-    return openGlShader;
+    compiled = true;
+    return true;
 }
 
 // Memory freeage
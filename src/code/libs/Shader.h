@@ -3,20 +3,59 @@
 #include "../../includes/packs/windowImports.h"
 #include "../../includes/packs/fileImports.h"
 #include <filesystem>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
 
 using namespace std;
 
+// Compile time settings for a shader, each pair becomes "#define name value" right after #version
+typedef vector<pair<string, string>> ShaderDefines;
+
 class Shader {
     private:
 
+        // One shader file split into lines with its #include directives already found
+        // Cached by path and only re-read when the file's modified time changes
+        struct SourceFile {
+            filesystem::file_time_type modified;
+            vector<string> lines;
+            vector<int> includeLines; // Which lines are #include directives
+            vector<string> includePaths; // The resolved file for each of them
+            bool inMemory = false; // Set with setVirtualFile, never read from the disk
+        };
+
+        // Every file read this session, shared by every shader (and the compile thread)
+        static unordered_map<string, SourceFile> sourceCache;
+        static mutex sourceCacheMutex;
+
         // The actual compiled shader
         GLint shader;
 
         // The shaders code
-        const char* shaderText;
+        string shaderText;
+
+        // checkCompile's result, so it's only asked for (and printed) once
+        bool checked = false;
+        bool compiled = false;
 
         // The function to compile said shader
-        GLint compileShader(const char* shaderPath, GLint openGlShader);
+        GLint compileShader(const string &source, GLint openGlShader);
+
+        // Hands the code to the driver without waiting for the result
+        GLint submitShader(const string &source, GLint openGlShader);
+
+        // Split code into lines and find its includes, relative to the file's path
+        static void parseSource(istream &input, const string &path, SourceFile &source);
+
+        // Get a file from the cache, reading it if it's new or changed (lock must be held)
+        static const SourceFile* loadSourceFile(const string &path);
+
+        // Write a file into output with its includes expanded (lock must be held)
+        static void expandSource(const string &path, int fileNumber, string &output, vector<string> &files);
+
+        // Swap the file numbers in a compile log for the file paths
+        static string mapErrorLog(const string &log, const string &source);
 
     public:
 
@@ -26,12 +65,49 @@ class Shader {
         // The main constructor with the path to file and the type of shader
         Shader(const char* shaderPath, GLint openGlShader);
 
+        // Same but specialized with a set of defines
+        Shader(const char* shaderPath, GLint openGlShader, const ShaderDefines &defines);
+
+        // Compiles a shader straight from its code
+        static Shader fromSource(const string &source, GLint openGlShader);
+
+        // Starts compiling a shader from its code without waiting on it, see isComplete and checkCompile
+        static Shader submit(const string &source, GLint openGlShader);
+
+        // Reads a shader file's code with every #include "file" resolved, without compiling it
+        static string readSource(const char* shaderPath);
+
+        // Same but also gives every file that went into it (the shader itself first)
+        static string readSource(const char* shaderPath, vector<string> &dependencies);
+
+        // Reads a shader file's code with its includes resolved and the defines injected
+        static string readSource(const char* shaderPath, const ShaderDefines &defines);
+
+        // Puts the defines right after the #version line, line numbers stay the same
+        static string injectDefines(const string &source, const ShaderDefines &defines);
+
+        // The defines as one string ("A=1;B=2"), the same set always gives the same key
+        static string definesKey(const ShaderDefines &defines);
+
+        // Every file a shader is built from, for watching them
+        static vector<string> getDependencies(const char* shaderPath);
+
+        // Puts generated code at a path so shaders can #include it like a file
+        // Replacing it only affects shaders read afterwards, they have to be rebuilt
+        static void setVirtualFile(const string &path, const string &code);
+
+        // Returns true once the driver finished compiling (always with no KHR_parallel_shader_compile)
+        bool isComplete();
+
+        // Waits for the compile and prints its log, returns true if it worked
+        bool checkCompile();
+
         // Returns the compiled shader
         GLint getShader() { return shader; };
 
         // Returns the shader's code
-        const char* getShaderText() { return shaderText; };
+        const char* getShaderText() { return shaderText.c_str(); };
 
         // Memory freeage
         void removeShader();
-};
\ No newline at end of file
+};
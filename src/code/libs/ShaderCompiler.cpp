@@ -0,0 +1,200 @@
+#include "ShaderCompiler.h"
+#include "ProgramCache.h"
+#include "GLExtensions.h"
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Window - the main window, its context is shared with the worker's
+// Cache Directory - where the worker's ProgramCache saves binaries
+ShaderCompiler::ShaderCompiler(Window &window, const std::string &cacheDirectory) {
+
+    this->cacheDirectory = cacheDirectory;
+    this->window = &window;
+
+    // Make a hidden context that shares the main window's objects
+    context = window.createSharedContext();
+
+    // No worker, request builds on this thread instead
+    if (context == NULL) {
+        cout << "Error creating the shader compiler context, shaders will be built on the main thread" << endl;
+        fallbackCache = ProgramCache(cacheDirectory);
+        return;
+    }
+
+    // Start the worker
+    running = true;
+    worker = std::thread(&ShaderCompiler::run, this);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Queue a build
+void ShaderCompiler::request(const std::string &vertexPath, const std::string &fragmentPath, const ShaderDefines &defines) {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Nothing would ever pick it up, so build it now (this stalls the frame like before the worker)
+    if (context == NULL) {
+
+        Program program = fallbackCache.load(vertexPath.c_str(), fragmentPath.c_str(), defines);
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        // Only the newest build matters
+        for (Result &result : results) {
+            glDeleteSync(result.fence);
+            result.program.kill();
+        }
+        results.clear();
+
+        results.push_back({program, fence, defines});
+        return;
+    }
+
+    // Only the newest request matters
+    requests.clear();
+    requests.push_back({vertexPath, fragmentPath, defines});
+
+    wake.notify_one();
+}
+
+// Check for a finished build
+bool ShaderCompiler::poll(Program &program) {
+    ShaderDefines defines;
+    return poll(program, defines);
+}
+
+// Check for a finished build and what it was built with
+bool ShaderCompiler::poll(Program &program, ShaderDefines &defines) {
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Nothing finished
+    if (results.empty()) {
+        return false;
+    }
+
+    Result &result = results.front();
+
+    // Don't wait at all, if the GPU isn't done we'll look again next frame
+    GLenum status = glClientWaitSync(result.fence, 0, 0);
+
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        return false;
+    }
+
+    // Hand it over
+    glDeleteSync(result.fence);
+    program = result.program;
+    defines = result.defines;
+    results.pop_front();
+
+    return true;
+}
+
+// If anything is in flight
+bool ShaderCompiler::isBusy() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return busy || !requests.empty() || !results.empty();
+}
+
+// The worker's loop
+void ShaderCompiler::run() {
+
+    // Everything on this thread uses the hidden context
+    window->makeContextCurrent(context);
+
+    // Let the driver spread compiles over its own threads too, the builds below poll for them to finish
+    if (GLExtensions::parallelShaderCompile) {
+        GLExtensions::glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+
+    // Binaries are per driver, so the cache is made with this context current
+    ProgramCache programCache(cacheDirectory);
+
+    while (true) {
+
+        Request current;
+
+        // Wait for work
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return !running || !requests.empty(); });
+
+            if (!running) {
+                break;
+            }
+
+            current = requests.front();
+            requests.pop_front();
+            busy = true;
+        }
+
+        // Build it (this is the slow part the main thread no longer waits on)
+        std::string vertexSource = Shader::readSource(current.vertexPath.c_str(), current.defines);
+        std::string fragmentSource = Shader::readSource(current.fragmentPath.c_str(), current.defines);
+
+        Program program;
+
+        if (!programCache.loadCached(vertexSource, fragmentSource, program)) {
+
+            // Both compiles and the link go to the driver's threads before we ask about any of them
+            program = programCache.submit(vertexSource, fragmentSource);
+
+            // Asking for a status before it's done would block on each stage in turn
+            while (!program.isComplete()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            program.finish();
+            programCache.store(vertexSource, fragmentSource, program);
+        }
+
+        // Fence so the main thread knows when the driver is really done with it
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        // Hand it to the main thread
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back({program, fence, current.defines});
+            busy = false;
+        }
+
+        // The main thread might be asleep waiting for events
+        window->wake();
+    }
+
+    window->makeContextCurrent(NULL);
+}
+
+// Stop and clean up
+void ShaderCompiler::kill() {
+
+    // Tell the worker to stop
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_one();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    // Free anything nobody picked up
+    for (Result &result : results) {
+        glDeleteSync(result.fence);
+        result.program.kill();
+    }
+    results.clear();
+
+    // Destroy the hidden context
+    if (context != NULL) {
+        window->destroySharedContext(context);
+        context = NULL;
+    }
+}
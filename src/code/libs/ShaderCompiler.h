@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+#include "../../includes/packs/standardImports.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+
+#include "./Window.h"
+#include "./Program.h"
+#include "./ProgramCache.h"
+
+class ShaderCompiler {
+
+    private:
+
+        // A program waiting to be built
+        struct Request {
+            std::string vertexPath;
+            std::string fragmentPath;
+            ShaderDefines defines;
+        };
+
+        // A built program and the fence that says the GPU side is done
+        struct Result {
+            Program program;
+            GLsync fence;
+            ShaderDefines defines; // What it was specialized with
+        };
+
+        // The window that made the shared context
+        Window* window;
+
+        // Hidden context that shares objects with the main one
+        void* context;
+
+        // Where the binary cache lives
+        std::string cacheDirectory;
+
+        // Builds on the calling thread when the hidden context couldn't be made
+        ProgramCache fallbackCache;
+
+        // The background thread
+        std::thread worker;
+
+        // Everything below is shared with the worker
+        std::mutex mutex;
+        std::condition_variable wake;
+
+        std::deque<Request> requests;
+        std::deque<Result> results;
+
+        bool running = false;
+        bool busy = false;
+
+        // The worker's loop
+        void run();
+
+    public:
+
+        // Constructor
+        // Creates the hidden shared context, must be called on the main thread
+        ShaderCompiler(Window &window, const std::string &cacheDirectory);
+
+        // Queue a program to be built, replaces anything that hasn't started yet
+        // Without the hidden context it's built right away and handed back by the next poll
+        void request(const std::string &vertexPath, const std::string &fragmentPath, const ShaderDefines &defines = ShaderDefines());
+
+        // Returns true and fills program once a build is finished and safe to draw with
+        // Check program.isLinked(), failed builds are handed back too
+        bool poll(Program &program);
+
+        // Same but also says which defines the program was built with
+        bool poll(Program &program, ShaderDefines &defines);
+
+        // Returns true while something is queued or building
+        bool isBusy();
+
+        // Stops the worker and frees the hidden context
+        void kill();
+};
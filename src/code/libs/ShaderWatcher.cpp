@@ -0,0 +1,144 @@
+#include "ShaderWatcher.h"
+
+#include <filesystem>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+
+
+// Normalize a path so event paths and watched paths compare equal
+static std::string normalizePath(const std::string &path) {
+    std::error_code error;
+    return std::filesystem::weakly_canonical(path, error).string();
+}
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Directory - the shader folder, sub folders (like includes) are watched too
+// Debounce Milliseconds - how long changes have to settle before poll fires
+ShaderWatcher::ShaderWatcher(const std::string &directory, int debounceMilliseconds) {
+
+    debounce = std::chrono::milliseconds(debounceMilliseconds);
+
+    // Start inotify, non-blocking so poll never stalls a frame
+    inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (inotify < 0) {
+        std::cout << "Error starting the shader watcher" << std::endl;
+        return;
+    }
+
+    // Watch the folder and everything in it
+    addDirectory(directory);
+
+    std::error_code error;
+    for (const std::filesystem::directory_entry &entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (entry.is_directory()) {
+            addDirectory(entry.path().string());
+        }
+    }
+}
+
+
+// ------------------------------- Setters --------------------------------------
+
+
+// Pick the files that trigger a rebuild
+void ShaderWatcher::setWatchedFiles(const std::vector<std::string> &files) {
+
+    watchedFiles.clear();
+
+    for (const std::string &file : files) {
+        watchedFiles.insert(normalizePath(file));
+    }
+
+    // Old changes were for the old files
+    pending = false;
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Watch one directory
+void ShaderWatcher::addDirectory(const std::string &directory) {
+
+    // Saves (close after write) and editors that save by renaming a temp file over the original
+    int watch = inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+    if (watch < 0) {
+        std::cout << "Error watching " << directory << std::endl;
+        return;
+    }
+
+    directories[watch] = normalizePath(directory);
+}
+
+// Check for changes
+bool ShaderWatcher::poll() {
+
+    // Not running
+    if (inotify < 0) {
+        return false;
+    }
+
+    // Room for a bunch of events at once
+    alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+
+    // Read until there's nothing left (read returns -1 right away when empty)
+    while (true) {
+
+        ssize_t length = read(inotify, buffer, sizeof(buffer));
+
+        if (length <= 0) {
+            break;
+        }
+
+        // Loop every event in the buffer
+        for (char* position = buffer; position < buffer + length; ) {
+
+            inotify_event* event = (inotify_event*)position;
+            position += sizeof(inotify_event) + event->len;
+
+            // Directory events have no name
+            if (event->len == 0) {
+                continue;
+            }
+
+            std::unordered_map<int, std::string>::iterator directory = directories.find(event->wd);
+
+            if (directory == directories.end()) {
+                continue;
+            }
+
+            // See if it's one of ours
+            std::string path = (std::filesystem::path(directory->second) / event->name).string();
+
+            if (watchedFiles.count(path)) {
+                pending = true;
+                lastChange = std::chrono::steady_clock::now();
+            }
+        }
+    }
+
+    // Fire once things have been quiet for the debounce time
+    if (pending && std::chrono::steady_clock::now() - lastChange >= debounce) {
+        pending = false;
+        return true;
+    }
+
+    return false;
+}
+
+// Stop watching
+void ShaderWatcher::kill() {
+
+    if (inotify >= 0) {
+        close(inotify);
+        inotify = -1;
+    }
+
+    directories.clear();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../../includes/packs/standardImports.h"
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+
+class ShaderWatcher {
+
+    private:
+
+        // The inotify instance (non-blocking)
+        int inotify = -1;
+
+        // Every watched directory by its watch descriptor
+        std::unordered_map<int, std::string> directories;
+
+        // The files that should trigger a rebuild
+        std::unordered_set<std::string> watchedFiles;
+
+        // Debounce state, editors often write a file more than once per save
+        bool pending = false;
+        std::chrono::steady_clock::time_point lastChange;
+        std::chrono::milliseconds debounce;
+
+        // Watch one directory
+        void addDirectory(const std::string &directory);
+
+    public:
+
+        // Constructor
+        // Watches the directory and every directory inside it
+        ShaderWatcher(const std::string &directory, int debounceMilliseconds);
+
+        // Set which files count, anything else in the directory is ignored
+        void setWatchedFiles(const std::vector<std::string> &files);
+
+        // Read any new events without blocking
+        // Returns true once a watched file changed and the debounce time passed
+        bool poll();
+
+        // Stops watching
+        void kill();
+
+        ShaderWatcher() {};
+};
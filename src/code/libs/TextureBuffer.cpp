@@ -0,0 +1,46 @@
+#include "TextureBuffer.h"
+
+#include <cstddef>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Unit - texture unit the shader's samplerBuffer is set to
+// Format - what each texel is, like GL_RGBA32F
+TextureBuffer::TextureBuffer(GLuint unit, GLenum format) {
+
+    this->unit = unit;
+    this->format = format;
+
+    glGenBuffers(1, &buffer);
+    glGenTextures(1, &texture);
+
+    // Start with one empty texel so the texture is never incomplete
+    update(NULL, 16);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// New contents
+void TextureBuffer::update(const void* data, GLsizeiptr size) {
+
+    // Fresh storage each time, the sizes change with the scene
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STATIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // Point the texture at it
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Memory freeage
+void TextureBuffer::kill() {
+    glDeleteTextures(1, &texture);
+    glDeleteBuffers(1, &buffer);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+// A buffer read in shaders through a samplerBuffer (texelFetch), GL 3.1 core so it works on our 3.3 context
+// Used for data too big for a uniform block, like the BVH
+class TextureBuffer {
+
+    private:
+
+        // The GL buffer and the texture that views it
+        GLuint buffer;
+        GLuint texture;
+
+        // Texel format, GL_RGBA32F for everything we upload
+        GLenum format;
+
+        // Texture unit it's bound to
+        GLuint unit;
+
+    public:
+
+        // Constructor
+        // Creates an empty buffer viewed as format, bound to the texture unit for good
+        TextureBuffer(GLuint unit, GLenum format);
+
+        // Getters
+        GLuint getUnit() { return unit; };
+        GLuint getTexture() { return texture; }; // For Program::bindSampler
+
+        // Methods
+        // Replaces the contents, size in bytes
+        void update(const void* data, GLsizeiptr size);
+
+        // Frees the buffer and the texture
+        void kill();
+
+        TextureBuffer() {};
+};
@@ -0,0 +1,47 @@
+#include "UniformBuffer.h"
+
+#include <cstddef>
+
+
+// ------------------------- Constructor(s) ------------------------------------
+
+
+// Binding - the uniform buffer binding point, programs tie their block to it with Program::bindUniformBlock
+// Size - size of the block in bytes
+UniformBuffer::UniformBuffer(GLuint binding, GLsizeiptr size) {
+
+    this->binding = binding;
+    this->size = size;
+
+    // Create the buffer with room for the block
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // Bind it to the binding point, this is context state so it survives program changes
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Upload the whole block
+void UniformBuffer::update(const void* data) {
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+
+    // Orphan the old storage so we never wait on a draw that is still reading it
+    glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+
+    // Then fill the fresh storage
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Memory freeage
+void UniformBuffer::kill() {
+    glDeleteBuffers(1, &buffer);
+}
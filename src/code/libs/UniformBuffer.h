@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+class UniformBuffer {
+
+    private:
+
+        // The GL buffer
+        GLuint buffer;
+
+        // The binding point it stays bound to
+        GLuint binding;
+
+        // Size of the data in bytes
+        GLsizeiptr size;
+
+    public:
+
+        // Constructor
+        // Creates the buffer and binds it to the binding point for good
+        UniformBuffer(GLuint binding, GLsizeiptr size);
+
+        // Getters
+        GLuint getBuffer() { return buffer; };
+        GLuint getBinding() { return binding; };
+
+        // Methods
+        // Uploads the whole block in one call, data must be size bytes
+        void update(const void* data);
+
+        // Frees the buffer
+        void kill();
+
+        UniformBuffer() {};
+};
@@ -0,0 +1,180 @@
+#include "UniformState.h"
+
+
+// ------------------------------- Staging --------------------------------------
+
+
+// Int
+void UniformState::setInt(GLint location, int value) {
+
+    // Inactive uniform
+    if (location < 0) { return; }
+
+    Value &current = slot(location);
+
+    // Same as what is already staged or uploaded
+    if (current.type == GL_INT && current.integer == value) {
+        pendingSkips++;
+        return;
+    }
+
+    current.type = GL_INT;
+    current.integer = value;
+    markDirty(location, current);
+}
+
+// Float
+void UniformState::setFloat(GLint location, float value) {
+
+    // Inactive uniform
+    if (location < 0) { return; }
+
+    Value &current = slot(location);
+
+    // Same as what is already staged or uploaded
+    if (current.type == GL_FLOAT && current.floats[0] == value) {
+        pendingSkips++;
+        return;
+    }
+
+    current.type = GL_FLOAT;
+    current.floats[0] = value;
+    markDirty(location, current);
+}
+
+// Array 2 float
+void UniformState::setArrayf2(GLint location, const float value[2]) {
+
+    // Inactive uniform
+    if (location < 0) { return; }
+
+    Value &current = slot(location);
+
+    // Same as what is already staged or uploaded
+    if (current.type == GL_FLOAT_VEC2 &&
+        current.floats[0] == value[0] &&
+        current.floats[1] == value[1]) {
+
+        pendingSkips++;
+        return;
+    }
+
+    current.type = GL_FLOAT_VEC2;
+    current.floats[0] = value[0];
+    current.floats[1] = value[1];
+    markDirty(location, current);
+}
+
+// Array 3 float
+void UniformState::setArrayf3(GLint location, const float value[3]) {
+
+    // Inactive uniform
+    if (location < 0) { return; }
+
+    Value &current = slot(location);
+
+    // Same as what is already staged or uploaded
+    if (current.type == GL_FLOAT_VEC3 &&
+        current.floats[0] == value[0] &&
+        current.floats[1] == value[1] &&
+        current.floats[2] == value[2]) {
+
+        pendingSkips++;
+        return;
+    }
+
+    current.type = GL_FLOAT_VEC3;
+    current.floats[0] = value[0];
+    current.floats[1] = value[1];
+    current.floats[2] = value[2];
+    markDirty(location, current);
+}
+
+
+// ------------------------------- Methods --------------------------------------
+
+
+// Upload every dirty value
+void UniformState::flush() {
+
+    // Loop only the values that changed
+    for (GLint location : dirtyLocations) {
+
+        Value &value = values[location];
+
+        // Upload by type
+        switch (value.type) {
+            case GL_INT:
+                glUniform1i(location, value.integer);
+                break;
+            case GL_FLOAT:
+                glUniform1f(location, value.floats[0]);
+                break;
+            case GL_FLOAT_VEC2:
+                glUniform2f(location, value.floats[0], value.floats[1]);
+                break;
+            case GL_FLOAT_VEC3:
+                glUniform3f(location, value.floats[0], value.floats[1], value.floats[2]);
+                break;
+        }
+
+        value.dirty = false;
+    }
+
+    // Save the stats for this flush
+    uploadCount = (int)dirtyLocations.size();
+    skippedCount = pendingSkips;
+
+    // Start the next batch
+    dirtyLocations.clear();
+    pendingSkips = 0;
+}
+
+// Forget everything
+void UniformState::reset() {
+    values.clear();
+    dirtyLocations.clear();
+    pendingSkips = 0;
+}
+
+// Mark a uniform as transient
+void UniformState::setTransient(GLint location) {
+
+    // Inactive uniform
+    if (location < 0) { return; }
+
+    slot(location).transient = true;
+}
+
+// Check the queued values for a real change
+bool UniformState::hasPendingChanges() {
+
+    for (GLint location : dirtyLocations) {
+        if (!values[location].transient) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Get a location's slot
+UniformState::Value& UniformState::slot(GLint location) {
+
+    // Grow to fit (locations are small so this only happens the first few sets)
+    if (location >= (GLint)values.size()) {
+        values.resize(location + 1);
+    }
+
+    return values[location];
+}
+
+// Queue a value for the next flush
+void UniformState::markDirty(GLint location, Value &value) {
+
+    // Only queue it once
+    if (!value.dirty) {
+        value.dirty = true;
+        dirtyLocations.push_back(location);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../../includes/packs/windowImports.h"
+
+#include <vector>
+
+class UniformState {
+
+    private:
+
+        // One uniform's last known value
+        struct Value {
+            GLenum type = 0; // GL_FLOAT, GL_FLOAT_VEC2, GL_FLOAT_VEC3 or GL_INT (0 until first set)
+            float floats[3] = {0.0f, 0.0f, 0.0f};
+            int integer = 0;
+            bool dirty = false; // Changed since the last flush
+            bool transient = false; // Changes every frame on purpose (like u_time), not a "real" change
+        };
+
+        // Values indexed directly by uniform location
+        std::vector<Value> values;
+
+        // Locations waiting to be uploaded
+        std::vector<GLint> dirtyLocations;
+
+        // Stats for the last flush
+        int uploadCount = 0;
+        int skippedCount = 0;
+
+        // Running count of redundant sets since the last flush
+        int pendingSkips = 0;
+
+        // Get the value slot for a location, growing the table if needed
+        Value& slot(GLint location);
+
+        // Mark a slot as needing an upload
+        void markDirty(GLint location, Value &value);
+
+    public:
+
+        // Stage values, these don't touch GL until flush
+        void setInt(GLint location, int value);
+        void setFloat(GLint location, float value);
+        void setArrayf2(GLint location, const float value[2]);
+        void setArrayf3(GLint location, const float value[3]);
+
+        // Upload every changed value in one pass, the program must be in use
+        void flush();
+
+        // Forget every known value so the next sets all upload
+        void reset();
+
+        // Mark a uniform that is expected to change every frame
+        // Its changes don't count for hasPendingChanges
+        void setTransient(GLint location);
+
+        // Returns true if a non-transient value is waiting to be uploaded
+        bool hasPendingChanges();
+
+        // Getters
+        int getUploadCount() { return uploadCount; }; // glUniform* calls made by the last flush
+        int getSkippedCount() { return skippedCount; }; // Sets that matched the uploaded value before the last flush
+};
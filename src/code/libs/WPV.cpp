@@ -1,32 +1,488 @@
 #include "./WPV.h"
 
+#include <cmath>
+#include <algorithm>
+
 
 // Constructor(s)
-WPV::WPV(Window window, Program program, WindowMesh* viewport) {
-    this->window = window;
+WPV::WPV(Window &window, Program program, WindowMesh* viewport) {
+    this->window = &window;
     this->program = program;
     this->viewport = viewport;
+
+    markTransientUniforms();
+}
+
+// Getters
+bool WPV::isAccumulating() {
+    // Only programs written for it can accumulate
+    return accumulationReady && accumulate && program.hasUniform("u_accumulate");
+}
+
+float WPV::getRenderScale() {
+    return rendersOffscreen() ? renderScale : 1.0f;
+}
+
+bool WPV::canIdle() {
+
+    if (!renderOnDemand || keepAliveFrames > 0) {
+        return false;
+    }
+
+    // Something changed that the last frame didn't draw yet
+    if (program.getUniformState().hasPendingChanges()) {
+        return false;
+    }
+
+    // Still adding samples
+    if (isAccumulating() && !accumulator.isConverged()) {
+        return false;
+    }
+
+    // The history is still settling
+    if (isDenoising() && !denoiser->isSettled()) {
+        return false;
+    }
+
+    // Captures are only collected while frames are drawn
+    if (capture != NULL && capture->isBusy()) {
+        return false;
+    }
+
+    return true;
+}
+
+void WPV::getRenderSize(int &width, int &height) {
+
+    // Scaled down part of the accumulator
+    if (rendersOffscreen()) {
+        width = std::max(1, (int)std::round(accumulator.getWidth() * renderScale));
+        height = std::max(1, (int)std::round(accumulator.getHeight() * renderScale));
+    }
+
+    // Straight to the window at the accumulator's size
+    else if (accumulationReady) {
+        width = accumulator.getWidth();
+        height = accumulator.getHeight();
+    }
+
+    // The whole viewport
+    else {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        width = viewport[2];
+        height = viewport[3];
+    }
+}
+
+bool WPV::isDenoising() {
+    // Only programs that write the G-buffer, the resolve program shows the result
+    return denoiser != NULL && denoise && accumulationReady && program.hasUniform("u_denoise");
+}
+
+bool WPV::rendersOffscreen() {
+    // Only programs written for the accumulator can be rendered into it
+    return (accumulationReady && program.hasUniform("u_accumulate") && (accumulate || dynamicResolution)) || isDenoising();
 }
 
 // Setters
 void WPV::setProgram(Program program) {
     this->program = program;
+
+    markTransientUniforms();
+
+    // The old history belongs to the old program
+    resetAccumulation();
+}
+
+void WPV::setAccumulation(bool accumulate) {
+
+    // Start fresh when it's turned on
+    if (accumulate && !this->accumulate) {
+        resetAccumulation();
+    }
+
+    this->accumulate = accumulate;
+
+    // Turning it off changes the path too
+    requestRedraw();
+}
+
+void WPV::setTonemapper(int tonemapper) {
+    this->tonemapper = tonemapper;
+    requestRedraw();
+}
+
+void WPV::setProfiler(Profiler* profiler) {
+    this->profiler = profiler;
+}
+
+void WPV::setDynamicResolution(bool dynamicResolution) {
+    this->dynamicResolution = dynamicResolution;
+
+    // Start from the full size again
+    renderScale = 1.0f;
+    requestRedraw();
+}
+
+void WPV::setFrameBudget(float frameBudget) {
+    this->frameBudget = frameBudget;
+}
+
+void WPV::setRenderOnDemand(bool renderOnDemand) {
+    this->renderOnDemand = renderOnDemand;
+    requestRedraw();
+}
+
+void WPV::setCapture(FrameCapture* capture) {
+    this->capture = capture;
+}
+
+void WPV::setPrepass(ConePrepass* prepass) {
+    this->prepass = prepass;
+}
+
+void WPV::setDenoiser(Denoiser* denoiser) {
+    this->denoiser = denoiser;
+}
+
+void WPV::setDenoising(bool denoise) {
+
+    // Start fresh when it's turned on
+    if (denoise && !this->denoise && denoiser != NULL) {
+        denoiser->reset();
+    }
+
+    this->denoise = denoise;
+    requestRedraw();
+}
+
+
+// Methods
+void WPV::initAccumulation(Program resolveProgram, int width, int height) {
+    this->resolveProgram = resolveProgram;
+    accumulator = Accumulator(width, height);
+    accumulationReady = true;
+}
+
+void WPV::resetAccumulation() {
+    if (accumulationReady) {
+        accumulator.reset();
+    }
+
+    if (denoiser != NULL) {
+        denoiser->reset();
+    }
+
+    requestRedraw();
+}
+
+void WPV::requestRedraw() {
+    // A few frames so the gui catches up too
+    keepAliveFrames = 3;
+}
+
+bool WPV::waitForChanges(double timeout) {
+
+    bool woken = window->waitEvents(timeout);
+
+    // Input usually changes the gui or the uniforms over the next couple of frames
+    if (woken) {
+        requestRedraw();
+    }
+
+    return woken;
+}
+
+void WPV::captureFrame(const std::string &path) {
+    // Read at the end of the frame, once the program has drawn
+    capturePath = path;
+}
+
+void WPV::updateCapture() {
+
+    if (capture == NULL) {
+        return;
+    }
+
+    profileBegin("Capture");
+
+    if (!capturePath.empty()) {
+
+        bool exr = capturePath.size() > 4 && capturePath.compare(capturePath.size() - 4, 4, ".exr") == 0;
+
+        // The denoised frame before the resolve pass tonemaps it
+        if (exr && isDenoising()) {
+            capture->captureFloat(capturePath, denoiser->getResultFramebuffer(), denoiser->getRenderWidth(), denoiser->getRenderHeight());
+        }
+
+        // The accumulator holds the linear average before the resolve pass tonemaps it
+        else if (exr && rendersOffscreen()) {
+            capture->captureFloat(capturePath, accumulator.getResultFramebuffer(), accumulator.getRenderWidth(), accumulator.getRenderHeight());
+        }
+
+        else if (exr) {
+            std::cout << "EXR captures need accumulation or dynamic resolution, " << capturePath << " was skipped" << std::endl;
+        }
+
+        // What the window shows
+        else {
+            capture->captureWindow(capturePath);
+        }
+
+        capturePath.clear();
+    }
+
+    // Older captures the GPU has finished go to the encoder
+    capture->update();
+
+    profileEnd("Capture");
+}
+
+void WPV::profileBegin(const std::string &name) {
+    if (profiler != NULL) {
+        profiler->begin(name);
+    }
+}
+
+void WPV::profileEnd(const std::string &name) {
+    if (profiler != NULL) {
+        profiler->end(name);
+    }
+}
+
+void WPV::updateRenderScale() {
+
+    // Needs the timings
+    if (!dynamicResolution || profiler == NULL) {
+        renderScale = 1.0f;
+        return;
+    }
+
+    // No result came back this frame
+    float shaderMs = profiler->getGpuMs("Shader");
+
+    if (shaderMs <= 0.0f) {
+        return;
+    }
+
+    // The shader's cost goes with the pixel count, so the scale goes with the square root of the time
+    float target = renderScale * std::sqrt(frameBudget / shaderMs);
+    target = std::min(1.0f, std::max(minRenderScale, target));
+
+    // Small differences are noise, every change restarts the accumulation
+    if (std::fabs(target - renderScale) < renderScale * 0.05f) {
+        return;
+    }
+
+    // Only go half way, the time is a few frames old and already partly reacted to
+    renderScale += (target - renderScale) * 0.5f;
+
+    // Steps of 1/64 so it settles on the same size
+    renderScale = std::round(renderScale * 64.0f) / 64.0f;
+}
+
+void WPV::markTransientUniforms() {
+    // Time and the sample count change every frame, they shouldn't restart the accumulation
+    program.getUniformState().setTransient(program.getUniformLocation("u_time"));
+    program.getUniformState().setTransient(program.getUniformLocation("u_sampleCount"));
+}
+
+void WPV::drawAccumulated() {
+
+    // The corner of the targets rendered this frame
+    int renderWidth;
+    int renderHeight;
+    getRenderSize(renderWidth, renderHeight);
+
+    accumulator.setRenderSize(renderWidth, renderHeight);
+
+    float renderSize[2] = { (float)renderWidth, (float)renderHeight };
+    program.setArrayf2("u_renderSize", renderSize);
+
+    // Only scaling, every frame stands on its own
+    if (!accumulate) {
+        accumulator.reset();
+    }
+
+    // A real change (mouse, sliders) means the history is stale
+    if (program.getUniformState().hasPendingChanges()) {
+        accumulator.reset();
+    }
+
+    // Once it's converged we just keep showing the result
+    if (!accumulator.isConverged()) {
+
+        // Tell the program to blend with the history
+        program.setBool("u_accumulate", true);
+        program.setInt("u_sampleCount", accumulator.getSampleCount());
+        program.setInt("u_accumulation", 0);
+        program.flushUniforms();
+
+        // Trace a sample into the accumulator
+        profileBegin("Shader");
+        accumulator.begin();
+        viewport->draw();
+        accumulator.end();
+        profileEnd("Shader");
+    }
+
+    else {
+        // Still upload so the changes are seen next frame
+        program.flushUniforms();
+    }
+
+    // Show the result on the window
+    drawResolved(accumulator.getResult(), renderSize);
+}
+
+void WPV::drawDenoised() {
+
+    // The corner of the G-buffer rendered this frame
+    int renderWidth;
+    int renderHeight;
+    getRenderSize(renderWidth, renderHeight);
+
+    float renderSize[2] = { (float)renderWidth, (float)renderHeight };
+    program.setArrayf2("u_renderSize", renderSize);
+
+    // Linear color and the G-buffer instead of blending with the accumulator
+    program.setBool("u_accumulate", false);
+
+    // The history follows the camera, but it has to settle again
+    if (program.getUniformState().hasPendingChanges()) {
+        denoiser->markChanged();
+    }
+
+    program.flushUniforms();
+
+    // Trace the frame
+    profileBegin("Shader");
+    denoiser->begin(renderWidth, renderHeight);
+    viewport->draw();
+    denoiser->end();
+    profileEnd("Shader");
+
+    profileBegin("Denoise");
+    denoiser->filter(viewport);
+    profileEnd("Denoise");
+
+    drawResolved(denoiser->getResult(), renderSize);
+}
+
+void WPV::drawResolved(GLuint texture, float renderSize[2]) {
+
+    profileBegin("Resolve");
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    resolveProgram.use();
+    resolveProgram.setInt("u_accumulation", 0);
+    resolveProgram.setInt("u_tonemapper", tonemapper);
+
+    float outputSize[2] = { (float)accumulator.getWidth(), (float)accumulator.getHeight() };
+    resolveProgram.setArrayf2("u_scaledSize", renderSize);
+    resolveProgram.setArrayf2("u_outputSize", outputSize);
+
+    resolveProgram.flushUniforms();
+
+    viewport->draw();
+
+    profileEnd("Resolve");
 }
 
 
 // Loop settings
 void WPV::start() {
+    // A new frame for the profiler (this also reads back older frames' timings)
+    if (profiler != NULL) {
+        profiler->beginFrame();
+    }
+
+    // React to the timings that just came back
+    updateRenderScale();
+
     // Start window proccess
-    window.start();
+    window->start();
+
+    // Raymarchers that start from the cone prepass need it drawn first, at the size they render at
+    if (prepass != NULL && program.hasUniform("u_coneDepth")) {
+
+        int renderWidth;
+        int renderHeight;
+        getRenderSize(renderWidth, renderHeight);
+
+        profileBegin("Prepass");
+        prepass->draw(viewport, renderWidth, renderHeight);
+        prepass->bindSamplers(program);
+        profileEnd("Prepass");
+    }
 
     // Use our shader program
     program.use();
 
+    // Programs written for the denoiser only fill in the G-buffer when they're told to
+    if (program.hasUniform("u_denoise")) {
+        program.setBool("u_denoise", isDenoising());
+    }
+
+    // Denoise the program if it supports it
+    if (isDenoising()) {
+        drawDenoised();
+        return;
+    }
+
+    // Accumulate (or scale) the program if it supports it
+    if (rendersOffscreen()) {
+        drawAccumulated();
+        return;
+    }
+
+    // Programs that can accumulate draw straight to the window when it's off
+    if (program.hasUniform("u_accumulate")) {
+        program.setBool("u_accumulate", false);
+    }
+
+    // At the window's size
+    if (accumulationReady) {
+        float renderSize[2] = { (float)accumulator.getWidth(), (float)accumulator.getHeight() };
+        program.setArrayf2("u_renderSize", renderSize);
+    }
+
+    // Upload the uniforms that changed last frame in one pass
+    program.flushUniforms();
+
     // Draw our viewport
+    profileBegin("Shader");
     viewport->draw();
+    profileEnd("Shader");
 }
 
 void WPV::end() {
-    // End window proccess
-    window.end();
-}
\ No newline at end of file
+    // Captures don't include the gui
+    updateCapture();
+
+    // Draw the gui
+    profileBegin("ImGui");
+    window->renderGui();
+    profileEnd("ImGui");
+
+    // Swap (this is where the CPU waits on vsync / a busy GPU)
+    profileBegin("Swap");
+    window->present();
+    profileEnd("Swap");
+
+    // One less frame to keep drawing
+    if (keepAliveFrames > 0) {
+        keepAliveFrames--;
+    }
+}
+
+void WPV::kill() {
+    if (accumulationReady) {
+        accumulator.kill();
+        resolveProgram.kill();
+        accumulationReady = false;
+    }
+}
@@ -5,34 +5,125 @@
 #include "./Window.h"
 #include "./Program.h"
 #include "./WindowMesh.h"
+#include "./Accumulator.h"
+#include "./Profiler.h"
+#include "./FrameCapture.h"
+#include "./ConePrepass.h"
+#include "./Denoiser.h"
 
 class WPV {
 
     private:
 
         // The Window Program Mesh part of WPV
-        Window window; // W
+        Window* window; // W (a pointer so a HeadlessWindow works too)
         Program program; // P
         WindowMesh* viewport; // V
 
+        // Progressive accumulation, the program renders into the accumulator and the resolve program shows it
+        Accumulator accumulator;
+        Program resolveProgram;
+        bool accumulationReady = false;
+        bool accumulate = false;
+
+        // Which curve the resolve pass uses (0 none, 1 Reinhard, 2 ACES)
+        int tonemapper = 0;
+
+        // Optional frame profiler
+        Profiler* profiler = NULL;
+
+        // Dynamic resolution, the program renders a fraction of the window that the resolve pass scales up
+        // The fraction follows the profiler's shader time to hold it at the budget
+        bool dynamicResolution = false;
+        float renderScale = 1.0f;
+        float minRenderScale = 0.25f;
+        float frameBudget = 16.0f; // ms of GPU time for the shader pass
+
+        // Optional frame capture, and the file the next frame goes to (empty for none)
+        FrameCapture* capture = NULL;
+        std::string capturePath;
+
+        // Optional low resolution pass programs built with CONE_START begin their rays from
+        ConePrepass* prepass = NULL;
+
+        // Optional denoiser, programs written for it (u_denoise) go through it instead of the accumulator
+        Denoiser* denoiser = NULL;
+        bool denoise = false;
+
+        // Render on demand, the loop sleeps in waitForChanges while nothing on screen would change
+        bool renderOnDemand = false;
+
+        // Frames still drawn after an event or change (imgui needs a couple to settle hover states and such)
+        int keepAliveFrames = 0;
+
+        // Move the scale towards the budget from the newest GPU time
+        void updateRenderScale();
+
+        // True if the program draws into the accumulator instead of the window
+        bool rendersOffscreen();
+
+        // The size the program renders at this frame
+        void getRenderSize(int &width, int &height);
+
+        // Time a part of the frame if there's a profiler
+        void profileBegin(const std::string &name);
+        void profileEnd(const std::string &name);
+
+        // Start the queued capture and collect finished ones
+        void updateCapture();
+
+        // Marks the uniforms that change every frame without changing the image
+        void markTransientUniforms();
+
+        // Trace one more sample into the accumulator and show it
+        void drawAccumulated();
+
+        // Trace a frame into the denoiser's G-buffer, filter it and show it
+        void drawDenoised();
+
+        // Show an offscreen result on the window, tonemapped and scaled up from the render size
+        void drawResolved(GLuint texture, float renderSize[2]);
+
     public:
 
         // Constructor(s)
-        WPV(Window window, Program program, WindowMesh* viewport);
+        WPV(Window &window, Program program, WindowMesh* viewport);
 
 
         // Getters
-        Window getWindow() { return window; }; // Window
-        Program getProgram() { return program; }; // Program
+        Window& getWindow() { return *window; }; // Window
+        Program& getProgram() { return program; }; // Program (by reference so setters don't copy it)
         WindowMesh* getViewport() { return viewport; }; // Mesh
+        Accumulator& getAccumulator() { return accumulator; }; // Accumulation targets
+        bool isAccumulating(); // True if the current program is being accumulated
+        float getRenderScale(); // Fraction of the window the program renders (1 unless dynamic resolution is on)
+        float getFrameBudget() { return frameBudget; }; // Shader time dynamic resolution aims for
+        bool canIdle(); // True if rendering on demand and the next frame would look the same as this one
+        bool isDenoising(); // True if the current program is being denoised
 
 
         // Setters
         void setProgram(Program program); // Updating to a new program
+        void setAccumulation(bool accumulate); // Turn progressive accumulation on or off
+        void setTonemapper(int tonemapper); // The resolve pass's curve, should match the program
+        void setProfiler(Profiler* profiler); // Times the shader, resolve, imgui and swap parts of every frame (NULL turns it off)
+        void setDynamicResolution(bool dynamicResolution); // Scale the render to hold the frame budget, needs the profiler and accumulation targets
+        void setFrameBudget(float frameBudget); // In milliseconds
+        void setRenderOnDemand(bool renderOnDemand); // Only draw when input, uniforms, the program or unconverged accumulation need it
+        void setCapture(FrameCapture* capture); // Lets captureFrame save frames (NULL turns it off)
+        void setPrepass(ConePrepass* prepass); // Drawn before programs that read u_coneDepth (NULL turns it off)
+        void setDenoiser(Denoiser* denoiser); // Used while denoising is on (NULL turns it off)
+        void setDenoising(bool denoise); // Filter programs that fill in a G-buffer instead of accumulating them, needs the accumulation targets
 
 
         // Methods
+        void initAccumulation(Program resolveProgram, int width, int height); // Make the targets, call once before accumulating
+        void resetAccumulation(); // Start over (scene changed), also asks for a redraw
+        void requestRedraw(); // Draw the next few frames even if no uniform changed (buffers, textures)
+        bool waitForChanges(double timeout); // Sleep until an event or wake, false if the timeout (seconds) ran out first
+        void captureFrame(const std::string &path); // Save this frame without the gui, .exr saves the linear accumulation (or denoised frame) instead
         void start(); // During your run loop, run this at the start
         void end(); // During your run loop, run this at the end
+        void kill(); // Frees the accumulation targets and the resolve program
 
-};
\ No newline at end of file
+};
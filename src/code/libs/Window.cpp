@@ -1,6 +1,7 @@
 #include "../../includes/packs/gui.h"
 
 #include "Window.h"
+#include "GLExtensions.h"
 
 
 // ----------------------------------- Constructor(s) -------------------------------
@@ -102,6 +103,12 @@ void Window::init(float width, float height) {
         cout << "OpenGl loaded successfully" << endl;
     }
 
+    // Load the entry points glad doesn't cover
+    GLExtensions::load((GLADloadproc)glfwGetProcAddress);
+
+    // Before imgui so its callbacks chain to ours
+    installEventCallbacks();
+
     if (imgui) {
         // Setup Dear ImGui context
         IMGUI_CHECKVERSION();
@@ -118,6 +125,32 @@ void Window::init(float width, float height) {
     glViewport(0, 0, width, height);
 }
 
+// Count every kind of event that can change what's on screen
+void Window::installEventCallbacks() {
+
+    glfwSetWindowUserPointer(window, this);
+
+    glfwSetCursorPosCallback(window, [](GLFWwindow* window, double, double) { countEvent(window); });
+    glfwSetMouseButtonCallback(window, [](GLFWwindow* window, int, int, int) { countEvent(window); });
+    glfwSetScrollCallback(window, [](GLFWwindow* window, double, double) { countEvent(window); });
+    glfwSetKeyCallback(window, [](GLFWwindow* window, int, int, int, int) { countEvent(window); });
+    glfwSetCharCallback(window, [](GLFWwindow* window, unsigned int) { countEvent(window); });
+    glfwSetCursorEnterCallback(window, [](GLFWwindow* window, int) { countEvent(window); });
+    glfwSetWindowFocusCallback(window, [](GLFWwindow* window, int) { countEvent(window); });
+    glfwSetWindowSizeCallback(window, [](GLFWwindow* window, int, int) { countEvent(window); });
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow* window) { countEvent(window); });
+}
+
+// One more event for the window that got it
+void Window::countEvent(GLFWwindow* window) {
+
+    Window* owner = (Window*)glfwGetWindowUserPointer(window);
+
+    if (owner != NULL) {
+        owner->eventCount++;
+    }
+}
+
 // If the window should still be open
 // True if it shouldn't close
 // False if it should
@@ -146,6 +179,16 @@ void Window::start() {
 // Run when finished with the run loop
 void Window::end() {
 
+    // Draw the gui over the frame
+    renderGui();
+
+    // Show it
+    present();
+}
+
+// Draw imgui
+void Window::renderGui() {
+
     // If im gui is used
     if (imgui) {
 
@@ -155,6 +198,10 @@ void Window::end() {
         // Render the draw data in open gl
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     }
+}
+
+// Swap and poll
+void Window::present() {
 
     // Swap the window buffers
     glfwSwapBuffers(window);
@@ -163,6 +210,50 @@ void Window::end() {
     glfwPollEvents();
 }
 
+// Sleep until something happens
+// Timeout - the longest to sleep, in seconds
+bool Window::waitEvents(double timeout) {
+
+    int before = eventCount;
+
+    glfwWaitEventsTimeout(timeout);
+
+    // Closing counts as something happening too
+    return eventCount != before || woken.exchange(false) || glfwWindowShouldClose(window);
+}
+
+// Wake the main thread up
+void Window::wake() {
+    woken = true;
+    glfwPostEmptyEvent();
+}
+
+// Mouse position
+void Window::getCursorPos(double* x, double* y) {
+    glfwGetCursorPos(window, x, y);
+}
+
+// A hidden 1x1 window that shares this window's objects
+void* Window::createSharedContext() {
+
+    // The other hints (GL version / profile) are still set from this window
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* context = glfwCreateWindow(1, 1, "Shared Context", NULL, window);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    return context;
+}
+
+// Use a shared context on this thread
+void Window::makeContextCurrent(void* context) {
+    glfwMakeContextCurrent((GLFWwindow*)context);
+}
+
+// Destroy the hidden window
+void Window::destroySharedContext(void* context) {
+    glfwDestroyWindow((GLFWwindow*)context);
+}
+
 // Kills the window and frees memory
 void Window::kill() {
 
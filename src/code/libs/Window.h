@@ -3,17 +3,27 @@
 #include "../../includes/packs/windowImports.h"
 #include "../../includes/packs/standardImports.h"
 
+#include <atomic>
+
 using namespace std;
 
 class Window {
 
-    private:
+    protected:
         // The GLFW window (the actual window)
-        GLFWwindow* window;
+        GLFWwindow* window = NULL;
 
         // If IMGUI is incorpriated
         bool imgui;
 
+        // Input and window events seen so far, so waitEvents can tell an event from a timeout
+        int eventCount = 0;
+
+        // Set from any thread by wake
+        atomic<bool> woken { false };
+
+    private:
+
         // Setting the necissary window hints with versions spesified
         void setWindowHints(int majorGlVersion, int minorGlVersion);
 
@@ -24,6 +34,10 @@ class Window {
         // Loads open gl
         void init(float width, float height);
 
+        // Counts events for waitEvents (installed before imgui's callbacks, which chain to them)
+        void installEventCallbacks();
+        static void countEvent(GLFWwindow* window);
+
     public:
 
         // Setup stuff
@@ -42,19 +56,49 @@ class Window {
         void setClearColor(float r, float g, float b, float a);
 
 
+        // Where the mouse is, in pixels from the top left
+        virtual void getCursorPos(double* x, double* y);
+
+
         // Methods
 
         // Returns true if the window should still be open
-        bool windowOpen();
+        virtual bool windowOpen();
 
         // Runs the start window stuff
-        void start();
+        virtual void start();
 
-        // Runs the end window stuff
-        void end();
+        // Runs the end window stuff (renderGui then present)
+        virtual void end();
+
+        // Draws imgui's frame
+        virtual void renderGui();
+
+        // Shows the frame and polls events
+        virtual void present();
+
+        // Sleeps until an event comes in, wake is called or the timeout (seconds) runs out
+        // Returns false if it timed out with nothing happening
+        virtual bool waitEvents(double timeout);
+
+        // Wakes a waitEvents, safe to call from any thread
+        virtual void wake();
 
         // Terminates the glfw window
-        void kill();
+        virtual void kill();
+
+
+        // Shared contexts (for the background shader compiler)
+
+        // Makes a context that shares objects with this one, returns NULL on failure
+        virtual void* createSharedContext();
+
+        // Makes a shared context current on the calling thread, NULL releases it
+        virtual void makeContextCurrent(void* context);
+
+        // Frees a shared context
+        virtual void destroySharedContext(void* context);
 
         Window() {};
+        virtual ~Window() {};
 };
\ No newline at end of file
@@ -2,8 +2,19 @@
 
 
 // Constructor
-WindowMesh::WindowMesh() {
-    
+WindowMesh::WindowMesh() : WindowMesh(true) {}
+
+// Fullscreen Triangle - draw one triangle made in the vertex shader from gl_VertexID
+WindowMesh::WindowMesh(bool fullscreenTriangle) {
+
+    this->fullscreenTriangle = fullscreenTriangle;
+
+    // The triangle needs no buffers, but core profile still wants a vertex array bound to draw
+    if (fullscreenTriangle) {
+        glGenVertexArrays(1, &VAO);
+        return;
+    }
+
     // Save every verticie
     float vertices[] = {
          1.0f,  1.0f, 0.0f,  // top right
@@ -59,14 +70,23 @@ void WindowMesh::draw() {
     // Bind our vertex array
     glBindVertexArray(VAO);
 
-    // Draw ou array and elements
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    // One triangle, every pixel shaded once
+    if (fullscreenTriangle) {
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        return;
+    }
+
+    // Draw our elements
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 }
 
 // Decanstructor
 WindowMesh::~WindowMesh() {
     glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+
+    // Only the quad has buffers
+    if (!fullscreenTriangle) {
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
 }
\ No newline at end of file
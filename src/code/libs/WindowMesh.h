@@ -7,12 +7,20 @@
 
 class WindowMesh {
     public:
+        // Fullscreen triangle (use with fullscreen.vert)
         WindowMesh();
+
+        // Fullscreen Triangle - false gives the old indexed quad (use with vertex.vert)
+        WindowMesh(bool fullscreenTriangle);
+
         void draw();
         ~WindowMesh();
 
     private:
         unsigned int VBO, VAO, EBO;
 
+        // One attributeless triangle instead of a two triangle quad
+        bool fullscreenTriangle;
+
         GLint mvp_location, vpos_location;
-};
\ No newline at end of file
+};
@@ -5,39 +5,252 @@
 #include "./libs/Program.h"
 #include "./libs/WindowMesh.h"
 #include "./libs/WPV.h"
+#include "./libs/ProgramCache.h"
+#include "./libs/ShaderCompiler.h"
+#include "./libs/ShaderWatcher.h"
+#include "./libs/ProgramVariants.h"
+#include "./libs/UniformBuffer.h"
+#include "./libs/SceneBlock.h"
+#include "./libs/SceneTextures.h"
+#include "./libs/SceneFile.h"
+#include "./libs/Profiler.h"
+#include "./libs/FrameCapture.h"
+#include "./libs/SdfScene.h"
+#include "./libs/SdfVolume.h"
+#include "./libs/SdfGlsl.h"
+#include "./libs/ConePrepass.h"
+#include "./libs/Denoiser.h"
+
+#include <cstdio>
+
+#ifdef HEADLESS_EGL
+#include "./libs/HeadlessWindow.h"
+#endif
 
 #define WIDTH 1200
 #define HEIGHT 650
 
+// Set by CMake to the source tree's shader folder
+#ifndef SHADER_DIR
+#define SHADER_DIR "src/shaders/"
+#endif
+
+// Same for the scene files
+#ifndef SCENE_DIR
+#define SCENE_DIR "src/scenes/"
+#endif
+
 using namespace std;
 
-int main() {  
+// Handles for every uniform the run loop sets
+// Reloaded whenever the program is rebuilt so the loop never looks anything up
+struct UniformHandles {
+    GLint mouseMove, mousePosX, mousePosY, previousMousePos, time;
+    GLint albedo, roughness, metallic, ambient;
+
+    void load(Program &program) {
+        mouseMove = program.getUniformLocation("u_mouseMove");
+        mousePosX = program.getUniformLocation("u_mousePosX");
+        mousePosY = program.getUniformLocation("u_mousePosY");
+        previousMousePos = program.getUniformLocation("u_previousMousePos");
+        time = program.getUniformLocation("u_time");
+
+        albedo = program.getUniformLocation("u_albedo");
+        roughness = program.getUniformLocation("u_roughness");
+        metallic = program.getUniformLocation("u_metallic");
+        ambient = program.getUniformLocation("u_ambient");
+    }
+};
+
+// Quality presets, each one is compiled into its own program variant
+// The shaders only #define these if they weren't given already
+const ShaderDefines qualityPresets[] {
+    {}, // Whatever each file defines itself
+    { {"MAX_BOUNCES", "1"}, {"SAMPLES", "1.0"} },
+    { {"MAX_BOUNCES", "4"}, {"SAMPLES", "4.0"} },
+    { {"MAX_BOUNCES", "8"}, {"SAMPLES", "8.0"} }
+};
+
+// How betterShader.frag marches, each combination is its own variant
+struct MarchOptions {
+    bool bakedSdf = false; // Step through the baked volume away from the surface
+    bool overRelaxation = false; // Stretch the steps, taking them back when they overshoot
+    bool conePrepass = false; // Start the rays from the low resolution cone pass
+    bool stepHeatmap = false; // Show map() calls per pixel instead of the picture
+    int normalMethod = 0; // common/normals.glsl's NORMAL_METHOD, 0 central, 1 tetrahedral, 2 analytic
+    bool boundsCulling = true; // Skip shapes in map() whose bounding spheres are too far to matter
+};
+
+// The quality preset plus the march options the shaders check for
+ShaderDefines buildDefines(int quality, const MarchOptions &options) {
+
+    ShaderDefines defines = qualityPresets[quality];
+
+    if (options.bakedSdf) {
+        defines.push_back({"BAKED_SDF", "1"});
+    }
+
+    if (options.overRelaxation) {
+        defines.push_back({"OVER_RELAXATION", "1.6"});
+    }
+
+    if (options.conePrepass) {
+        defines.push_back({"CONE_START", "1"});
+    }
+
+    if (options.stepHeatmap) {
+        defines.push_back({"STEP_HEATMAP", "1"});
+    }
+
+    // Culling is on unless it's turned off
+    if (!options.boundsCulling) {
+        defines.push_back({"SDF_CULLING", "0"});
+    }
+
+    // Central differences are the shaders' own default
+    if (options.normalMethod != 0) {
+        defines.push_back({"NORMAL_METHOD", to_string(options.normalMethod)});
+    }
+
+    return defines;
+}
+
+// The cone prepass is the same file marching cones, only the distance function settings carry over
+ShaderDefines buildPrepassDefines(int quality, const MarchOptions &options) {
+
+    MarchOptions prepassOptions;
+    prepassOptions.bakedSdf = options.bakedSdf;
+    prepassOptions.boundsCulling = options.boundsCulling;
+
+    ShaderDefines defines = buildDefines(quality, prepassOptions);
+    defines.push_back({"CONE_PREPASS", "1"});
+
+    return defines;
+}
+
+// Every file the two shaders are built from (includes too), for the watcher
+vector<string> shaderFiles(const string &vertexPath, const string &fragmentPath) {
+
+    vector<string> files = Shader::getDependencies(vertexPath.c_str());
+    vector<string> fragmentFiles = Shader::getDependencies(fragmentPath.c_str());
+
+    files.insert(files.end(), fragmentFiles.begin(), fragmentFiles.end());
+    return files;
+}
+
+// Copy the slider values into the scene's materials
+void applyMaterialSliders(SceneBlock &scene, float albedo[3], float roughness, float metallic, float ambient) {
+
+    // Both non-emmisive spheres share the albedo and metallic sliders
+    for (int i = 0; i < 2; i++) {
+        scene.spheres[i].material.albedo[0] = albedo[0];
+        scene.spheres[i].material.albedo[1] = albedo[1];
+        scene.spheres[i].material.albedo[2] = albedo[2];
+        scene.spheres[i].material.metallic = metallic;
+    }
+
+    // Only the ground gets the roughness slider
+    scene.spheres[0].material.roughness = roughness;
+
+    scene.ambient = ambient;
+}
+
+// The loaded scene plus some random spheres, uploaded with a fresh BVH
+void uploadPrimitiveScene(SceneTextures &textures, const PrimitiveScene &loaded, int extraSpheres) {
+
+    PrimitiveScene scene = loaded;
+    addRandomSpheres(scene, extraSpheres, 1337);
+
+    textures.upload(scene, Bvh(scene));
+}
+
+// A normal window, or with `--headless <frames> [frame.ppm]` an offscreen one (no display or GPU needed)
+Window* createWindow(int argc, char** argv) {
+
+    bool headless = argc > 1 && string(argv[1]) == "--headless";
+
+#ifdef HEADLESS_EGL
+    if (headless) {
+        int frames = argc > 2 ? atoi(argv[2]) : 1;
+        return new HeadlessWindow(WIDTH, HEIGHT, frames, true);
+    }
+#else
+    if (headless) {
+        cout << "Built without EGL, opening a normal window" << endl;
+    }
+#endif
+
+    return new Window(WIDTH, HEIGHT, "Hello, Window!", true);
+}
+
+int main(int argc, char** argv) {  
 
     // ------------------- Window -------------------------
 
 
     // Create a window
-    Window window(WIDTH, HEIGHT, "Hello, Window!", true);
+    Window* window = createWindow(argc, argv);
 
 
     // ----------------- Shader & Program -----------------
 
     // Variable for the fragment shader
     std::string fragmentShader = "fragment.frag";
-    std::string filePath = "/home/pkner/code/Shaders/src/shaders/";
+    std::string filePath = SHADER_DIR;
+    std::string vertexShader = filePath + "fullscreen.vert"; // Matches the viewport's fullscreen triangle
 
-    // Create our vertex and fragment shaders
-    Shader vertex("/home/pkner/code/Shaders/src/shaders/vertex.vert", GL_VERTEX_SHADER);
-    Shader fragment((filePath + fragmentShader).c_str(), GL_FRAGMENT_SHADER);
+    // Binary cache so unchanged shaders skip compiling and linking
+    ProgramCache programCache("shaderCache");
 
     // Create our shader program that holds everything to be ran
-    Program shaderProgram(vertex, fragment);
+    Program shaderProgram = programCache.load(vertexShader.c_str(), (filePath + fragmentShader).c_str());
+
+    // Every linked program, by file and quality preset, so switching presets back and forth doesn't rebuild
+    ProgramVariants programVariants;
+    programVariants.add(filePath + fragmentShader, qualityPresets[0], shaderProgram);
+
+    // Background compiler for every rebuild after this one
+    ShaderCompiler shaderCompiler(*window, "shaderCache");
+
+    // The cone prepass gets its own, a request to one replaces anything the same compiler hasn't started
+    ShaderCompiler prepassCompiler(*window, "shaderCache");
+
+    // Rebuild automatically when the active shader files (or anything they include) are saved
+    ShaderWatcher shaderWatcher(filePath, 150);
+    shaderWatcher.setWatchedFiles(shaderFiles(vertexShader, filePath + fragmentShader));
+
+    // Get the handles of the uniforms we set every frame
+    UniformHandles uniforms;
+    uniforms.load(shaderProgram);
+
+
+    // ----------------------- Scene -----------------------
+
+
+    // Scene block shared by every fragment shader that declares it
+    SceneBlock scene = createDefaultScene();
+    UniformBuffer sceneBuffer(SCENE_BLOCK_BINDING, sizeof(SceneBlock));
+    sceneBuffer.update(&scene);
+
+    // Tie the program's block to the buffer
+    shaderProgram.bindUniformBlock("SceneBlock", SCENE_BLOCK_BINDING);
+
+    // Sphere and box scene for the shaders that walk a BVH (oldFragment.frag), from a scene file
+    char scenePath[256] = SCENE_DIR "cornell.scene";
+
+    PrimitiveScene primitiveScene;
+    if (!loadSceneFile(scenePath, primitiveScene)) {
+        primitiveScene = createCornellBoxScene();
+    }
+
+    SceneTextures sceneTextures(true);
+    uploadPrimitiveScene(sceneTextures, primitiveScene, 0);
 
 
     // ---------------------- Viewport ---------------------
 
 
-    // Create our viewport triangles
+    // Create our viewport triangle
     WindowMesh* viewport = new WindowMesh();
 
 
@@ -45,22 +258,77 @@ int main() {
 
 
     // Set a clear color in our window
-    window.setClearColor(0.0, 0.0, 0.0, 1.0);
+    window->setClearColor(0.0, 0.0, 0.0, 1.0);
 
 
     // -------------------------- WPV -----------------------
 
 
-    WPV wpv = WPV(window, shaderProgram, viewport);
+    WPV wpv = WPV(*window, shaderProgram, viewport);
+
+    // Progressive accumulation, the resolve program shows (and tonemaps) the averaged samples
+    Program resolveProgram = programCache.load(vertexShader.c_str(), (filePath + "resolve.frag").c_str());
+    wpv.initAccumulation(resolveProgram, WIDTH, HEIGHT);
+    wpv.setTonemapper(1);
+
+    // Spatiotemporal filter for a few samples per pixel, programs that fill in a G-buffer go through it when it's on
+    Program temporalProgram = programCache.load(vertexShader.c_str(), (filePath + "temporal.frag").c_str());
+    Program filterProgram = programCache.load(vertexShader.c_str(), (filePath + "atrous.frag").c_str());
+
+    Denoiser denoiser(temporalProgram, filterProgram, WIDTH, HEIGHT);
+    wpv.setDenoiser(&denoiser);
+
+    // Frame timings, shown in their own panel
+    Profiler profiler;
+    wpv.setProfiler(&profiler);
+
+    // Screenshots and sequences, read back and written in the background
+    FrameCapture frameCapture;
+    wpv.setCapture(&frameCapture);
+
+    std::error_code captureError;
+    std::filesystem::create_directories("captures", captureError);
+
+    // Low resolution cone pass, built when a program wants to start from it
+    ConePrepass conePrepass(true);
+    wpv.setPrepass(&conePrepass);
+
+    // betterShader.frag's map(), included by the shader as generated code and baked into a 3D texture the first time it's turned on
+    SdfScene sdfScene = createBetterShaderScene();
+    Shader::setVirtualFile(filePath + "generated/sdfScene.glsl", generateSdfGlsl(sdfScene));
+
+    SdfVolume sdfVolume(true);
+    SdfBakeSettings sdfSettings;
 
     
     // --------------------- Run Loop -----------------------
 
     int selected = 0;
+
+    // The selection the running program was built from (selected changes before the build finishes)
+    int requested = 0;
+    int active = 0;
+
+    // Quality preset the next builds use
+    int quality = 0;
+
+    bool accumulate = false;
+    bool denoise = false;
+
+    bool dynamicResolution = false;
+    float frameBudget = wpv.getFrameBudget();
     
     bool mouseMove = false;
     int time = 0;
 
+    // Where the camera looks from, only follows the cursor while "Mouse" is on (so reaching for the gui doesn't restart anything)
+    // The middle of the window looks straight ahead
+    double cameraMouseX = WIDTH / 2.0;
+    double cameraMouseY = HEIGHT / 2.0;
+
+    // The mouse as of last frame, the denoiser follows the camera's move from there
+    float previousMousePos[2] = { 0.0, 0.0 };
+
     float albedo[3];
     albedo[0] = 0.0;
     albedo[1] = 0.0;
@@ -70,7 +338,39 @@ int main() {
     float metallic = 0.0;
     float ambient = 0.0;
 
-    while(window.windowOpen()) {
+    // Random spheres added to the BVH scene
+    int extraSpheres = 0;
+
+    // betterShader.frag's march variant
+    MarchOptions marchOptions;
+
+    // Baked SDF settings, the resolution is along the longest side
+    int sdfResolution = 64;
+    float sdfMargin = 0.5;
+    float sdfBakeMs = 0.0;
+
+    // Random shapes added around the pipe, every change regenerates map() and rebakes
+    int extraSdfShapes = 0;
+    bool sdfStale = false;
+
+    bool renderOnDemand = false;
+
+    // Numbers the captured files, a recorded sequence saves every frame
+    int captureNumber = 0;
+    bool recording = false;
+
+    while(window->windowOpen()) {
+
+        // On demand, sleep while the frame wouldn't change
+        // Input and finished builds wake it, saved shader files don't so they're checked every timeout
+        bool hotReload = false;
+
+        while (wpv.canIdle() && !wpv.waitForChanges(0.25)) {
+            if (shaderWatcher.poll()) {
+                hotReload = true;
+                break;
+            }
+        }
 
         // Start proccess
         wpv.start();
@@ -78,57 +378,413 @@ int main() {
 
         /* BASE */
 
-        if (ImGui::Button("Compile", ImVec2(100, 50))) {
+        // Compiling happens in the background, we keep drawing the old program until it's done
+        // Saving one of the active files does the same as pressing the button
+        hotReload |= shaderWatcher.poll();
 
-            shaderProgram.kill();
+        // Set when the cone prepass has to be rebuilt along with the program
+        bool prepassStale = false;
 
-            Shader vertex("/home/pkner/code/Shaders/src/shaders/vertex.vert", GL_VERTEX_SHADER);
-            Shader fragment((filePath + fragmentShader).c_str(), GL_FRAGMENT_SHADER);
+        if (ImGui::Button("Compile", ImVec2(100, 50)) || hotReload) {
 
-            shaderProgram = Program(vertex, fragment);
+            prepassStale = true;
 
-            wpv.setProgram(shaderProgram);
+            // Every other variant was built from the old files
+            programVariants.invalidate(shaderProgram.getProgram());
+
+            shaderCompiler.request(vertexShader, filePath + fragmentShader, buildDefines(quality, marchOptions));
+            requested = selected;
+        }
+
+        if (shaderCompiler.isBusy() || prepassCompiler.isBusy()) {
+            ImGui::SameLine();
+            ImGui::Text("Compiling...");
         }
 
         const char* fragmentShaders[] {
             "fragment.frag",
             "oldFragment.frag",
-            "oldFragmentPBR.frag"
+            "oldFragmentPBR.frag",
+            "betterShader.frag"
         };
 
-        ImGui::ListBox("Fragment Shader File", &selected, fragmentShaders, 3);
+        // The tonemapper each of those uses when accumulating (1 Reinhard, 2 ACES, 0 none)
+        const int tonemappers[] { 1, 2, 0, 0 };
+
+        // Swap in a finished program
+        Program compiled;
+        ShaderDefines compiledDefines;
+        int swappedFile = -1; // Which of fragmentShaders is being swapped in this frame
+
+        if (shaderCompiler.poll(compiled, compiledDefines)) {
+
+            // Keep the old program if this one failed
+            if (compiled.isLinked()) {
+
+                // The variants own the programs now (an older build of the same one is killed once it isn't drawn)
+                programVariants.add(filePath + fragmentShaders[requested], compiledDefines, compiled, shaderProgram.getProgram());
+
+                // Only if it's still what's picked, the user could have moved on (or back to a built variant) meanwhile
+                if (requested == selected && compiledDefines == buildDefines(quality, marchOptions)) {
+                    shaderProgram = compiled;
+                    swappedFile = requested;
+                }
+            }
+
+            else {
+                cout << "Build failed, keeping the previous program" << endl;
+                compiled.kill();
+            }
+
+            // The includes might have changed
+            shaderWatcher.setWatchedFiles(shaderFiles(vertexShader, filePath + fragmentShader));
+        }
+
+        // Compile time quality and march options, an already built variant is swapped in right away
+        const char* qualityNames[] { "Default", "Fast", "High", "Ultra" };
+
+        bool variantChanged = ImGui::Combo("Quality", &quality, qualityNames, 4);
+
+        if (fragmentShader == "betterShader.frag") {
+            variantChanged |= ImGui::Checkbox("Baked SDF", &marchOptions.bakedSdf);
+            ImGui::SameLine();
+            variantChanged |= ImGui::Checkbox("Over-relaxation", &marchOptions.overRelaxation);
+            variantChanged |= ImGui::Checkbox("Cone prepass", &marchOptions.conePrepass);
+            ImGui::SameLine();
+            variantChanged |= ImGui::Checkbox("Step heatmap", &marchOptions.stepHeatmap);
+
+            // map() calls per hit: 6, 4 and 1 (the heatmap counts them too)
+            const char* normalMethods[] { "Central normals", "Tetrahedral normals", "Analytic normals" };
+            variantChanged |= ImGui::Combo("Normals", &marchOptions.normalMethod, normalMethods, 3);
+
+            variantChanged |= ImGui::Checkbox("Bounds culling", &marchOptions.boundsCulling);
+
+            // Only rebuilt once the slider is let go
+            ImGui::SliderInt("Extra SDF shapes", &extraSdfShapes, 0, 500);
+
+            if (ImGui::IsItemDeactivatedAfterEdit()) {
+
+                sdfScene = createBetterShaderScene();
+                addRandomSdfShapes(sdfScene, extraSdfShapes, 1337);
+
+                Shader::setVirtualFile(filePath + "generated/sdfScene.glsl", generateSdfGlsl(sdfScene));
+
+                // Every variant includes the old map()
+                prepassStale = true;
+                programVariants.invalidate(shaderProgram.getProgram());
+
+                shaderCompiler.request(vertexShader, filePath + fragmentShader, buildDefines(quality, marchOptions));
+                requested = selected;
+
+                sdfStale = true;
+            }
+        }
+
+        if (variantChanged) {
+
+            prepassStale = true;
+
+            if (programVariants.find(filePath + fragmentShader, buildDefines(quality, marchOptions), shaderProgram)) {
+                swappedFile = selected;
+            }
+
+            else {
+                shaderCompiler.request(vertexShader, filePath + fragmentShader, buildDefines(quality, marchOptions));
+                requested = selected;
+            }
+        }
+
+        // The prepass is another variant of the same file, the old one was killed along with the others or doesn't fit anymore
+        if (prepassStale) {
+
+            conePrepass.clearProgram();
+
+            if (marchOptions.conePrepass && fragmentShader == "betterShader.frag") {
+
+                Program prepassProgram;
+
+                if (programVariants.find(filePath + fragmentShader, buildPrepassDefines(quality, marchOptions), prepassProgram)) {
+                    conePrepass.setProgram(prepassProgram);
+                }
+
+                else {
+                    prepassCompiler.request(vertexShader, filePath + fragmentShader, buildPrepassDefines(quality, marchOptions));
+                }
+            }
+        }
+
+        // Swap in a finished prepass, the full resolution pass starts its rays from zero until then
+        Program compiledPrepass;
+        ShaderDefines compiledPrepassDefines;
+
+        if (prepassCompiler.poll(compiledPrepass, compiledPrepassDefines)) {
+
+            if (compiledPrepass.isLinked()) {
+
+                programVariants.add(filePath + "betterShader.frag", compiledPrepassDefines, compiledPrepass);
+
+                // The options could have moved on while it was building
+                if (marchOptions.conePrepass && fragmentShader == "betterShader.frag" && compiledPrepassDefines == buildPrepassDefines(quality, marchOptions)) {
+                    conePrepass.setProgram(compiledPrepass);
+                }
+            }
 
-        fragmentShader = fragmentShaders[selected];
+            else {
+                cout << "Cone prepass build failed" << endl;
+                compiledPrepass.kill();
+            }
+        }
+
+        if (swappedFile != -1) {
+
+            shaderProgram.bindUniformBlock("SceneBlock", SCENE_BLOCK_BINDING);
+
+            wpv.setProgram(shaderProgram);
+
+            uniforms.load(shaderProgram);
+
+            // Each shader leaves a different curve to the resolve pass
+            active = swappedFile;
+            wpv.setTonemapper(tonemappers[active]);
+        }
+
+
+        if (ImGui::ListBox("Fragment Shader File", &selected, fragmentShaders, 4)) {
+
+            fragmentShader = fragmentShaders[selected];
+
+            // Watch the newly picked file instead
+            shaderWatcher.setWatchedFiles(shaderFiles(vertexShader, filePath + fragmentShader));
+        }
 
         
         ImGui::Checkbox("Mouse", &mouseMove);
-        wpv.getProgram().setBool("u_mouseMove", mouseMove);
+        wpv.getProgram().setBool(uniforms.mouseMove, mouseMove);
 
-        double mouseXPos;
-        double mouseYPos;
-        glfwGetCursorPos(wpv.getWindow().getWindow(), &mouseXPos, &mouseYPos);
+        if (mouseMove) {
+            wpv.getWindow().getCursorPos(&cameraMouseX, &cameraMouseY);
+        }
+
+        // Held still values don't count as a change, so the accumulation and the denoiser's history carry on
+        double mouseXPos = cameraMouseX;
+        double mouseYPos = cameraMouseY;
 
-        wpv.getProgram().setFloat("u_mousePosX", mouseXPos);
-        wpv.getProgram().setFloat("u_mousePosY", mouseYPos);
+        // The shaders compare the mouse with their render size, which shrinks with dynamic resolution
+        wpv.getProgram().setFloat(uniforms.mousePosX, mouseXPos * wpv.getRenderScale());
+        wpv.getProgram().setFloat(uniforms.mousePosY, mouseYPos * wpv.getRenderScale());
 
-        wpv.getProgram().setInt("u_time", time);
+        wpv.getProgram().setArrayf2(uniforms.previousMousePos, previousMousePos);
+        previousMousePos[0] = mouseXPos * wpv.getRenderScale();
+        previousMousePos[1] = mouseYPos * wpv.getRenderScale();
+
+        wpv.getProgram().setInt(uniforms.time, time);
+
+        // The prepass has to march the same rays
+        if (conePrepass.isReady()) {
+            conePrepass.getProgram().setFloat("u_mousePosX", mouseXPos * wpv.getRenderScale());
+            conePrepass.getProgram().setFloat("u_mousePosY", mouseYPos * wpv.getRenderScale());
+        }
 
         /* BASE */
 
 
         /* EXTRA */
 
-        ImGui::ColorEdit3("Albedo", albedo);
-        wpv.getProgram().setArrayf3("u_albedo", albedo);
+        bool materialChanged = false;
+
+        materialChanged |= ImGui::ColorEdit3("Albedo", albedo);
+        wpv.getProgram().setArrayf3(uniforms.albedo, albedo);
+
+        materialChanged |= ImGui::SliderFloat("Roughness", &roughness, 0.0, 1.0);
+        wpv.getProgram().setFloat(uniforms.roughness, roughness);
+
+        materialChanged |= ImGui::SliderFloat("Metallic", &metallic, 0.0, 1.0);
+        wpv.getProgram().setFloat(uniforms.metallic, metallic);
+
+        materialChanged |= ImGui::SliderFloat("Ambient", &ambient, 0.0, 1.0);
+        wpv.getProgram().setFloat(uniforms.ambient, ambient);
+
+        // Shaders with the scene block get the whole thing in one upload, only when a slider moved
+        if (materialChanged) {
+            applyMaterialSliders(scene, albedo, roughness, metallic, ambient);
+            sceneBuffer.update(&scene);
+
+            // The buffer isn't a uniform so the program can't notice this by itself
+            wpv.resetAccumulation();
+        }
+
+        // Only shaders that walk the BVH can show the extra spheres
+        if (wpv.getProgram().hasUniform("u_bvhNodes")) {
+
+            ImGui::InputText("Scene", scenePath, sizeof(scenePath));
+
+            // A new layout is just another upload, no rebuild
+            bool sceneChanged = false;
+
+            if (ImGui::Button("Load scene")) {
+                sceneChanged = loadSceneFile(scenePath, primitiveScene);
+            }
+
+            ImGui::SameLine();
+
+            // The binary form sits next to the text one and loads without parsing
+            if (ImGui::Button("Save binary")) {
+                std::filesystem::path binaryPath = scenePath;
+                saveSceneBinary(binaryPath.replace_extension(".sceneb").string(), primitiveScene);
+            }
+
+            // Rebuild the whole thing, it's quick enough for a slider
+            sceneChanged |= ImGui::SliderInt("Extra spheres", &extraSpheres, 0, 5000);
+
+            if (sceneChanged) {
+                uploadPrimitiveScene(sceneTextures, primitiveScene, extraSpheres);
+                wpv.resetAccumulation();
+            }
+
+            sceneTextures.bindSamplers(wpv.getProgram());
+
+            wpv.getProgram().setArrayf3("u_cameraPosition", primitiveScene.camera.position);
+            wpv.getProgram().setFloat("u_cameraFov", primitiveScene.camera.fov);
+        }
+
+
+        /* SDF */
+
+        // The marcher reads the baked volume instead of running the whole map() far from the surface
+        if (marchOptions.bakedSdf && string(fragmentShaders[active]) == "betterShader.frag") {
 
-        ImGui::SliderFloat("Roughness", &roughness, 0.0, 1.0);
-        wpv.getProgram().setFloat("u_roughness", roughness);
+            ImGui::SliderInt("SDF resolution", &sdfResolution, 16, 256);
+            ImGui::SliderFloat("SDF margin", &sdfMargin, 0.1, 2.0);
 
-        ImGui::SliderFloat("Metallic", &metallic, 0.0, 1.0);
-        wpv.getProgram().setFloat("u_metallic", metallic);
+            // Baked the first time it's needed, then whenever asked
+            if (ImGui::Button("Bake") || !sdfVolume.isBaked() || sdfStale) {
+                fitSdfBounds(sdfScene, sdfMargin, sdfResolution, sdfSettings);
+                sdfBakeMs = sdfVolume.bake(sdfScene, sdfSettings);
+                sdfStale = false;
+                wpv.requestRedraw();
+            }
 
-        ImGui::SliderFloat("Ambient", &ambient, 0.0, 1.0);
-        wpv.getProgram().setFloat("u_ambient", ambient);
+            ImGui::SameLine();
+            ImGui::Text("%dx%dx%d in %.1f ms", sdfSettings.resolution[0], sdfSettings.resolution[1], sdfSettings.resolution[2], sdfBakeMs);
+
+            sdfVolume.bindSamplers(wpv.getProgram());
+
+            if (conePrepass.isReady()) {
+                sdfVolume.bindSamplers(conePrepass.getProgram());
+            }
+        }
+
+
+        /* ACCUMULATION */
+
+        // Average samples over frames while nothing changes
+        if (ImGui::Checkbox("Accumulate", &accumulate)) {
+            wpv.setAccumulation(accumulate);
+        }
+
+        if (wpv.isAccumulating()) {
+            ImGui::SameLine();
+            ImGui::Text("Samples: %d", wpv.getAccumulator().getSampleCount());
+        }
+
+
+        /* DENOISE */
+
+        // Filter the few samples of each frame over space and time instead of averaging thousands
+        if (ImGui::Checkbox("Denoise", &denoise)) {
+            wpv.setDenoising(denoise);
+        }
+
+        if (wpv.isDenoising()) {
+
+            bool denoiserChanged = false;
+
+            bool temporal = denoiser.isTemporal();
+            if (ImGui::Checkbox("Temporal", &temporal)) {
+                denoiser.setTemporal(temporal);
+                denoiserChanged = true;
+            }
+
+            int filterPasses = denoiser.getFilterPasses();
+            if (ImGui::SliderInt("Filter passes", &filterPasses, 0, 5)) {
+                denoiser.setFilterPasses(filterPasses);
+                denoiserChanged = true;
+            }
+
+            // Lower is smoother, higher follows changes in the lighting faster
+            float minBlend = denoiser.getMinBlend();
+            if (ImGui::SliderFloat("History blend", &minBlend, 0.02, 1.0)) {
+                denoiser.setMinBlend(minBlend);
+                denoiserChanged = true;
+            }
+
+            if (denoiserChanged) {
+                denoiser.markChanged();
+                wpv.requestRedraw();
+            }
+        }
+
+
+        /* POWER */
+
+        // Stop redrawing a picture that isn't changing
+        if (ImGui::Checkbox("Render on demand", &renderOnDemand)) {
+            wpv.setRenderOnDemand(renderOnDemand);
+        }
+
+
+        /* RESOLUTION */
+
+        // Render fewer pixels when the shader goes over budget, scaled back up before the gui
+        if (ImGui::Checkbox("Dynamic resolution", &dynamicResolution)) {
+            wpv.setDynamicResolution(dynamicResolution);
+        }
+
+        if (dynamicResolution) {
+
+            if (ImGui::SliderFloat("Budget (ms)", &frameBudget, 1.0, 50.0)) {
+                wpv.setFrameBudget(frameBudget);
+            }
+
+            ImGui::Text("Render scale: %.2f", wpv.getRenderScale());
+        }
+
+
+        /* CAPTURE */
+
+        // Stills without the gui, EXR keeps the accumulation's linear values
+        char capturePath[64] = "";
+
+        if (ImGui::Button("Save PNG")) {
+            snprintf(capturePath, sizeof(capturePath), "captures/frame_%05d.png", captureNumber++);
+        }
+
+        ImGui::SameLine();
+
+        if (ImGui::Button("Save EXR")) {
+            snprintf(capturePath, sizeof(capturePath), "captures/frame_%05d.exr", captureNumber++);
+        }
+
+        ImGui::SameLine();
+        ImGui::Checkbox("Record", &recording);
+
+        if (recording) {
+            snprintf(capturePath, sizeof(capturePath), "captures/frame_%05d.png", captureNumber++);
+        }
+
+        if (capturePath[0] != '\0') {
+            wpv.captureFrame(capturePath);
+        }
+
+        ImGui::Text("Captured: %d (written %d)", frameCapture.getCapturedCount(), frameCapture.getWrittenCount());
+
+
+        /* STATS */
+
+        UniformState& uniformState = wpv.getProgram().getUniformState();
+        ImGui::Text("Uniform uploads: %d (skipped %d)", uniformState.getUploadCount(), uniformState.getSkippedCount());
+
+        profiler.drawPanel();
 
 
 
@@ -144,9 +800,39 @@ int main() {
     // -------------------- Post-Run loop --------------------
 
 
-    // Kill our shader program
-    shaderProgram.kill();
+    // Stop the background compilers and the watcher
+    shaderCompiler.kill();
+    prepassCompiler.kill();
+    shaderWatcher.kill();
+
+    // Kill our shader programs (every variant, the running one and the prepass too)
+    programVariants.kill();
+
+    // Free the accumulation targets and the resolve program
+    wpv.kill();
+
+    // Finish writing captures
+    frameCapture.kill();
+
+    // Free the timer queries
+    profiler.kill();
+
+    // Free the scene buffers
+    sceneBuffer.kill();
+    sceneTextures.kill();
+    sdfVolume.kill();
+    conePrepass.kill();
+    denoiser.kill();
+
+#ifdef HEADLESS_EGL
+    // Headless runs can keep their last frame
+    HeadlessWindow* headless = dynamic_cast<HeadlessWindow*>(window);
+    if (headless != NULL && argc > 3) {
+        headless->saveFrame(argv[3]);
+    }
+#endif
 
     // Kill our window
-    window.kill();
+    window->kill();
+    delete window;
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#version 330 core
+
+// One pass of the Denoiser's edge-avoiding a-trous wavelet filter (Dammertz et al. 2010)
+// A 5x5 B3 spline kernel with its taps u_stepSize pixels apart, each pass doubles the step so a few passes cover a wide area
+// Taps across an edge in the G-buffer (normal, depth, albedo) or the color itself get little weight
+
+uniform sampler2D u_color;
+uniform sampler2D u_normalDepth;
+uniform sampler2D u_albedo;
+
+// The rendered corner of the targets, in pixels
+uniform vec2 u_renderSize;
+
+// Pixels between taps
+uniform int u_stepSize;
+
+// How much each difference is allowed before a tap is ignored, larger blurs more
+uniform float u_colorPhi;
+uniform float u_normalPhi;
+uniform float u_depthPhi;
+uniform float u_albedoPhi;
+
+layout(location = 0) out vec4 fragColor;
+
+// B3 spline weights from the center out
+const float kernel[3] = float[3](3.0 / 8.0, 1.0 / 4.0, 1.0 / 16.0);
+
+void main() {
+
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+    vec3 color = texelFetch(u_color, pixel, 0).rgb;
+    vec4 normalDepth = texelFetch(u_normalDepth, pixel, 0);
+    vec3 albedo = texelFetch(u_albedo, pixel, 0).rgb;
+
+    // The background passes through, still marked display ready
+    if (normalDepth.w <= 0.0) {
+        fragColor = vec4(color, 0.0);
+        return;
+    }
+
+    vec3 sum = vec3(0.0);
+    float weights = 0.0;
+
+    for (int y = -2; y <= 2; y++) {
+        for (int x = -2; x <= 2; x++) {
+
+            ivec2 tap = pixel + ivec2(x, y) * u_stepSize;
+
+            if (any(lessThan(tap, ivec2(0))) || any(greaterThanEqual(tap, ivec2(u_renderSize)))) {
+                continue;
+            }
+
+            vec4 tapNormalDepth = texelFetch(u_normalDepth, tap, 0);
+
+            // Never blend the background in
+            if (tapNormalDepth.w <= 0.0) {
+                continue;
+            }
+
+            vec3 tapColor = texelFetch(u_color, tap, 0).rgb;
+            vec3 tapAlbedo = texelFetch(u_albedo, tap, 0).rgb;
+
+            vec3 colorDifference = color - tapColor;
+            vec3 albedoDifference = albedo - tapAlbedo;
+
+            // Depth is allowed to change more further out, the taps are further apart
+            float colorWeight = exp(-dot(colorDifference, colorDifference) / u_colorPhi);
+            float normalWeight = pow(max(dot(normalDepth.xyz, tapNormalDepth.xyz), 0.0), u_normalPhi);
+            float depthWeight = exp(-abs(normalDepth.w - tapNormalDepth.w) / (u_depthPhi * float(u_stepSize)));
+            float albedoWeight = exp(-dot(albedoDifference, albedoDifference) / u_albedoPhi);
+
+            float weight = kernel[abs(x)] * kernel[abs(y)] * colorWeight * normalWeight * depthWeight * albedoWeight;
+
+            sum += tapColor * weight;
+            weights += weight;
+        }
+    }
+
+    // The center tap always counts, so weights is never 0
+    fragColor = vec4(sum / weights, 1.0);
+}
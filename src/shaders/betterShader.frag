@@ -0,0 +1,264 @@
+#version 330 core
+precision mediump float;
+
+// ------------------------ Uniforms ---------------------
+
+in vec2 u_resolution;
+
+uniform float u_mousePosX;
+uniform float u_mousePosY;
+
+// -----------------------  Defines ----------------------
+
+
+#define ASPECT_RATIO u_resolution.x / u_resolution.y
+#define FOV 10.0
+
+// March settings, the app can inject its own after #version (see Shader::injectDefines)
+#ifndef MAX_STEPS
+#define MAX_STEPS 200
+#endif
+
+#ifndef EPSILON
+#define EPSILON 0.001
+#endif
+
+#ifndef MAX_DIST
+#define MAX_DIST 100.0
+#endif
+
+// Steps are stretched by this much and taken back if they jump past the surface (1.0 is plain sphere tracing)
+#ifndef OVER_RELAXATION
+#define OVER_RELAXATION 1.0
+#endif
+
+// Pixels per side of a cone prepass tile (match CONE_TILE in ConePrepass.h)
+#define CONE_TILE 8
+
+vec2 u_mouse = vec2(u_mousePosX, u_mousePosY);
+
+
+// ----------------------- Includes ----------------------
+
+#include "common/math.glsl"
+#include "common/sdf.glsl"
+
+// Baked mode, the app injects BAKED_SDF once SdfVolume holds a bake of map() (see Shader::injectDefines)
+#ifdef BAKED_SDF
+uniform sampler3D u_sdfVolume;
+uniform vec3 u_sdfBoundsMin;
+uniform vec3 u_sdfBoundsMax;
+uniform float u_sdfVoxelDiagonal;
+#endif
+
+
+// -------------------- Structs --------------------------
+
+
+struct Ray {
+    vec3 orgin;
+    vec3 direction;
+};
+
+
+// map() and mapGradient(), written by the app from the same SdfScene it bakes (see generateSdfGlsl)
+// Shapes whose bounding spheres are further than the distance so far are skipped
+#include "generated/sdfScene.glsl"
+
+// The distance the march steps by, the baked volume stands in for map() away from the surface
+float marchDistance(vec3 position) {
+
+#ifdef BAKED_SDF
+    vec3 size = u_sdfBoundsMax - u_sdfBoundsMin;
+
+    // Outside the volume, its box is closer than anything in it (the nudge gets the ray over the edge)
+    float outside = sdBox(position - (u_sdfBoundsMin + u_sdfBoundsMax) * 0.5, size * 0.5);
+
+    if (outside > 0.0) {
+        return outside + EPSILON * 10.0;
+    }
+
+    // Interpolation can overshoot by up to half a voxel's diagonal, stay under the real distance
+    float baked = texture(u_sdfVolume, (position - u_sdfBoundsMin) / size).r - u_sdfVoxelDiagonal * 0.5;
+
+    // Near the surface the exact map() takes over so hits and normals stay sharp
+    if (baked < u_sdfVoxelDiagonal) {
+        return map(position);
+    }
+
+    return baked;
+#else
+    return map(position);
+#endif
+}
+
+// ----------------------- Shaders -----------------------
+
+#include "common/normals.glsl"
+
+// The camera ray through a pixel, both passes have to agree on it
+Ray cameraRay(vec2 pixel) {
+
+    vec2 uv = (pixel * 2. - u_resolution.xy) / u_resolution.y;
+    vec2 m = (u_mouse.xy * 2.0 - u_resolution.xy) / u_resolution.y;
+
+    Ray ray = Ray(
+        vec3(0.0, 0.0, -10.0),
+        normalize(vec3(uv, 1.0))
+    );
+
+    float mouseModifier = 2.0;
+
+    ray.orgin.xz *= rot2D(-m.x * mouseModifier);
+    ray.direction.xz *= rot2D(-m.x * mouseModifier);
+
+    ray.orgin.yz *= rot2D(m.y * mouseModifier);
+    ray.direction.yz *= rot2D(m.y * mouseModifier);
+
+    return ray;
+}
+
+#ifdef CONE_PREPASS
+
+// How far a cone around a whole tile can go before something might be inside it
+// Drawn at one pixel per tile, every ray in the tile can start from the result
+float coneMarch() {
+
+    Ray ray = cameraRay((floor(gl_FragCoord.xy) + 0.5) * float(CONE_TILE));
+
+    // The cone's radius per unit of distance, half a tile's diagonal (rays further out only get closer together)
+    float spread = float(CONE_TILE) * 1.41421356 / u_resolution.y;
+
+    float t = 0.0;
+    float safe = 0.0; // Furthest t where the whole cone was inside a sphere
+
+    for (int i = 0; i < MAX_STEPS; i++) {
+
+        float d = marchDistance(ray.orgin + ray.direction * t);
+
+        // The sphere doesn't cover the cone anymore
+        if (d < t * spread + EPSILON || t > MAX_DIST) {
+            break;
+        }
+
+        safe = t;
+        t += d;
+    }
+
+    return safe;
+}
+
+#endif
+
+#ifdef CONE_START
+// The cone prepass's distances, one texel per tile
+uniform sampler2D u_coneDepth;
+#endif
+
+#ifdef STEP_HEATMAP
+// Steps that show as full red, most pixels take far fewer than MAX_STEPS
+#ifndef HEATMAP_STEPS
+#define HEATMAP_STEPS 64
+#endif
+
+// Blue (few steps) through green to red (HEATMAP_STEPS or more)
+vec3 heatmap(float amount) {
+    return clamp(vec3(amount * 2.0 - 0.5, 1.0 - abs(amount * 2.0 - 1.0), 1.5 - amount * 3.0), 0.0, 1.0);
+}
+#endif
+
+vec3 render() {
+
+    vec3 col = vec3(0.1608, 0.1608, 0.1608);   // Template color that will be modified
+
+    Ray ray = cameraRay(gl_FragCoord.xy);
+
+    float t = 0.; // total distance travelled
+
+#ifdef CONE_START
+    // Skip the empty space the whole tile already got through
+    t = texelFetch(u_coneDepth, ivec2(gl_FragCoord.xy) / CONE_TILE, 0).r;
+#endif
+
+    float omega = OVER_RELAXATION;
+    float stepLength = 0.0;
+    float previousRadius = 0.0;
+
+    bool hit = false;
+    int steps = 0;
+
+    for (int i = 0; i < MAX_STEPS; i++) {
+
+        vec3 p = ray.orgin + ray.direction * t;     // position along the ray
+
+        float d = marchDistance(p);         // current distance to the scene
+        steps++;
+
+        // The stretched step went past where this sphere and the last one meet, so it could have skipped a surface
+        // Go back inside the last sphere and march plainly from there
+        bool overshot = omega > 1.0 && abs(d) + previousRadius < stepLength;
+
+        if (overshot) {
+            stepLength -= omega * stepLength;
+            omega = 1.0;
+        }
+
+        else {
+            stepLength = d * omega;
+        }
+
+        previousRadius = abs(d);
+
+        t += stepLength;                   // "march" the ray
+
+        if (!overshot && d < EPSILON) {
+            hit = true;
+            break; // early stop if close enough
+        }
+
+        if (t > MAX_DIST) {
+            break;      // early stop if too far
+        }
+    }
+
+    if (hit) {
+        vec3 normal = calculateNormal(ray.orgin + ray.direction * t, t);
+        steps += NORMAL_MAP_CALLS;
+
+        vec3 lightColor = vec3(1.0, 0.15, 0.82);
+        vec3 lightSource = vec3(1.0, 1.0, -1.0);
+        float diffuseStrength = max(0.0, dot(normalize(lightSource), normal));
+        vec3 diffuse = lightColor * diffuseStrength;
+
+        vec3 viewSource = normalize(ray.orgin);
+        vec3 reflectSource = normalize(reflect(-lightSource, normal));
+        float specularStrength = max(0.0, dot(viewSource, reflectSource));
+        specularStrength = pow(specularStrength, 64.0);
+        vec3 specular = specularStrength * lightColor;
+
+        vec3 lighting = diffuse * 0.75 + specular * 0.25;
+        col = lighting;
+
+        col *= t / 8.0;
+
+        // col = vec3(t / 100.0);
+    }
+
+#ifdef STEP_HEATMAP
+    // map() calls for this pixel instead of the picture
+    return heatmap(min(float(steps) / float(HEATMAP_STEPS), 1.0));
+#endif
+
+    return pow(col, vec3(1.0 / 2.0));
+}
+
+
+// ------------------------ Other ------------------------
+
+void main() {
+#ifdef CONE_PREPASS
+    gl_FragColor = vec4(coneMarch(), 0.0, 0.0, 1.0);
+#else
+    gl_FragColor = vec4(render(), 1.0);
+#endif
+}
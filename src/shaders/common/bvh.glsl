@@ -0,0 +1,153 @@
+// BVH traversal over the sphere / box scene SceneTextures uploads
+// Needs the including shader's Ray, HitInfo, Sphere, Box and intersect() (see oldFragment.frag)
+
+// 2 texels per node: [min, leftOrFirst] [max, count], a node's left child is the next node
+uniform samplerBuffer u_bvhNodes;
+
+// 2 texels per primitive: [center, type | hiddenFromCamera << 1] [size, material]
+uniform samplerBuffer u_primitives;
+
+// 3 texels per material: [color, roughness] [specularColor, specularProbability] [emmisive, 0]
+uniform samplerBuffer u_materials;
+
+#define PRIMITIVE_SPHERE 0
+#define PRIMITIVE_BOX 1
+
+// Deep enough for Bvh's max depth of 30
+#define BVH_STACK_SIZE 32
+
+RayTracingMaterial fetchMaterial(int index) {
+
+    vec4 a = texelFetch(u_materials, index * 3);
+    vec4 b = texelFetch(u_materials, index * 3 + 1);
+    vec4 c = texelFetch(u_materials, index * 3 + 2);
+
+    return RayTracingMaterial(a.rgb, b.rgb, c.rgb, a.w, b.w);
+}
+
+// Distance to where the ray enters the box, or -1.0 if it misses (or it's further than maxDist)
+float intersectBounds(vec3 orgin, vec3 inverseDirection, vec3 boundsMin, vec3 boundsMax, float maxDist) {
+
+    vec3 t1 = (boundsMin - orgin) * inverseDirection;
+    vec3 t2 = (boundsMax - orgin) * inverseDirection;
+
+    vec3 tSmall = min(t1, t2);
+    vec3 tBig = max(t1, t2);
+
+    float tN = max(max(tSmall.x, tSmall.y), tSmall.z);
+    float tF = min(min(tBig.x, tBig.y), tBig.z);
+
+    if (tN > tF || tF < 0.0 || tN > maxDist) return -1.0;
+
+    // Starting inside counts as entering right away
+    return max(tN, 0.0);
+}
+
+// Closest hit in the scene, camera rays skip primitives flagged as hidden from the camera
+HitInfo traverseBvh(Ray ray, bool cameraRay) {
+
+    HitInfo closestHit;
+    closestHit.hit = false;
+    closestHit.dist = 800000.0;
+
+    // The material is only fetched once, for the final hit
+    int closestMaterial = -1;
+
+    // Materials are filled in later so the intersectors don't need one
+    RayTracingMaterial noMaterial = RayTracingMaterial(vec3(0.0), vec3(0.0), vec3(0.0), 0.0, 0.0);
+
+    vec3 inverseDirection = 1.0 / ray.direction;
+
+    int stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+
+    // Start at the root if the ray touches it at all
+    int node = 0;
+
+    vec4 rootMin = texelFetch(u_bvhNodes, 0);
+    vec4 rootMax = texelFetch(u_bvhNodes, 1);
+
+    // An empty scene's root (see Bvh.h), it has no children to go to
+    if (rootMin.w < 0.0) {
+        return closestHit;
+    }
+
+    if (intersectBounds(ray.orgin, inverseDirection, rootMin.xyz, rootMax.xyz, closestHit.dist) < 0.0) {
+        return closestHit;
+    }
+
+    while (true) {
+
+        vec4 nodeMin = texelFetch(u_bvhNodes, node * 2);
+        vec4 nodeMax = texelFetch(u_bvhNodes, node * 2 + 1);
+
+        int count = int(nodeMax.w);
+
+        // Leaf, test its primitives
+        if (count > 0) {
+
+            int first = int(nodeMin.w);
+
+            for (int i = first; i < first + count; i++) {
+
+                vec4 a = texelFetch(u_primitives, i * 2);
+                vec4 b = texelFetch(u_primitives, i * 2 + 1);
+
+                int flags = int(a.w);
+
+                if (cameraRay && (flags & 2) != 0) continue;
+
+                HitInfo hit;
+
+                if ((flags & 1) == PRIMITIVE_SPHERE) {
+                    hit = intersect(ray, Sphere(a.xyz, b.x, noMaterial));
+                }
+                else {
+                    hit = intersect(ray, Box(a.xyz, b.xyz, noMaterial));
+                }
+
+                if (hit.hit && hit.dist < closestHit.dist) {
+                    closestHit = hit;
+                    closestMaterial = int(b.w);
+                }
+            }
+        }
+
+        // Inner node, visit the nearer child first and save the other for later
+        else {
+
+            int left = node + 1;
+            int right = int(nodeMin.w);
+
+            float leftDist = intersectBounds(ray.orgin, inverseDirection, texelFetch(u_bvhNodes, left * 2).xyz, texelFetch(u_bvhNodes, left * 2 + 1).xyz, closestHit.dist);
+            float rightDist = intersectBounds(ray.orgin, inverseDirection, texelFetch(u_bvhNodes, right * 2).xyz, texelFetch(u_bvhNodes, right * 2 + 1).xyz, closestHit.dist);
+
+            if (leftDist >= 0.0 && rightDist >= 0.0) {
+
+                int nearChild = leftDist <= rightDist ? left : right;
+                int farChild = leftDist <= rightDist ? right : left;
+
+                if (stackSize < BVH_STACK_SIZE) {
+                    stack[stackSize++] = farChild;
+                }
+
+                node = nearChild;
+                continue;
+            }
+
+            if (leftDist >= 0.0) { node = left; continue; }
+            if (rightDist >= 0.0) { node = right; continue; }
+        }
+
+        // Nothing left to visit
+        if (stackSize == 0) break;
+
+        node = stack[--stackSize];
+    }
+
+    if (closestHit.hit) {
+        closestHit.material = fetchMaterial(closestMaterial);
+    }
+
+    return closestHit;
+}
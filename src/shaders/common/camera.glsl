@@ -0,0 +1,65 @@
+// fragment.frag's pinhole camera, and the way back from a point to the pixel it lands on (for reprojection)
+// Include after math.glsl
+
+// Where the camera sits before the mouse turns it
+#ifndef CAMERA_ORIGIN
+#define CAMERA_ORIGIN vec3(-5.0, 0.0, -10.0)
+#endif
+
+// Vertical field of view in degrees
+#ifndef CAMERA_FOV
+#define CAMERA_FOV 30.0
+#endif
+
+// How far a mouse move turns it
+#ifndef CAMERA_MOUSE_SCALE
+#define CAMERA_MOUSE_SCALE 3.0
+#endif
+
+// The camera's turn around y then x for a mouse position, none when it doesn't follow the mouse
+vec2 cameraAngles(vec2 mouse, vec2 resolution, bool orbit) {
+
+    if (!orbit) {
+        return vec2(0.0);
+    }
+
+    vec2 m = (mouse * 2.0 - resolution) / resolution.y;
+    return vec2(-m.x, m.y) * CAMERA_MOUSE_SCALE;
+}
+
+// Camera space to the scene
+vec3 cameraRotate(vec3 v, vec2 angles) {
+    v.xz *= rot2D(angles.x);
+    v.yz *= rot2D(angles.y);
+    return v;
+}
+
+// And back, the opposite turns in the opposite order
+vec3 cameraUnrotate(vec3 v, vec2 angles) {
+    v.yz *= rot2D(-angles.y);
+    v.xz *= rot2D(-angles.x);
+    return v;
+}
+
+// Screen coordinates of a pixel, y from -tan(fov / 2) to tan(fov / 2)
+vec2 cameraUv(vec2 pixel, vec2 resolution) {
+    float angle = tan((PI * 0.5 * CAMERA_FOV) / 180.0);
+    return ((pixel / resolution) * 2.0 - 1.0) * vec2(resolution.x / resolution.y, 1.0) * angle;
+}
+
+// The ray through a pixel
+void cameraRay(vec2 pixel, vec2 resolution, vec2 angles, out vec3 origin, out vec3 direction) {
+    origin = cameraRotate(CAMERA_ORIGIN, angles);
+    direction = cameraRotate(normalize(vec3(cameraUv(pixel, resolution), 1.0)), angles);
+}
+
+// The pixel a point lands on (xy) and how far it is from the camera (z)
+vec3 cameraProject(vec3 position, vec2 resolution, vec2 angles) {
+
+    vec3 local = cameraUnrotate(position, angles) - CAMERA_ORIGIN;
+
+    float angle = tan((PI * 0.5 * CAMERA_FOV) / 180.0);
+    vec2 uv = local.xy / local.z / (vec2(resolution.x / resolution.y, 1.0) * angle);
+
+    return vec3((uv + 1.0) * 0.5 * resolution, length(local));
+}
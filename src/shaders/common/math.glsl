@@ -0,0 +1,16 @@
+// Shared constants and small helpers
+
+#ifndef PI
+#define PI 3.14159265359
+#endif
+
+#ifndef TWO_PI
+#define TWO_PI 6.28318530718
+#endif
+
+// Rotation matrix for mouse movement
+mat2 rot2D(float angle) {
+    float s = sin(angle);
+    float c = cos(angle);
+    return mat2(c, -s, s, c);
+}
@@ -0,0 +1,64 @@
+// Surface normals for the raymarchers
+// Include after map() (and mapGradient() for the analytic method), then call calculateNormal
+//
+// NORMAL_METHOD picks how, per shader or injected by the app:
+//   0 central differences, 6 map() calls
+//   1 tetrahedral differences, 4 map() calls
+//   2 analytic, one mapGradient() call that carries the gradient with the distance (see the *Gradient functions in sdf.glsl)
+
+#ifndef NORMAL_METHOD
+#define NORMAL_METHOD 0
+#endif
+
+// The offset grows with the distance so far away hits don't resolve detail smaller than a pixel
+// and close ones don't blur theirs
+#ifndef NORMAL_EPSILON_SCALE
+#define NORMAL_EPSILON_SCALE 0.001
+#endif
+
+#ifndef NORMAL_EPSILON_MIN
+#define NORMAL_EPSILON_MIN 0.0001
+#endif
+
+// map() calls per normal, so step counts can include them
+#if NORMAL_METHOD == 0
+#define NORMAL_MAP_CALLS 6
+#elif NORMAL_METHOD == 1
+#define NORMAL_MAP_CALLS 4
+#else
+#define NORMAL_MAP_CALLS 1
+#endif
+
+// Offset for a hit t along the ray
+float normalEpsilon(float t) {
+    return max(NORMAL_EPSILON_MIN, t * NORMAL_EPSILON_SCALE);
+}
+
+// Position - the hit
+// T - how far along the ray it is
+vec3 calculateNormal(vec3 position, float t) {
+
+#if NORMAL_METHOD == 2
+    return normalize(mapGradient(position).yzw);
+
+#elif NORMAL_METHOD == 1
+    // Four corners of a tetrahedron, their weighted sum is the gradient
+    vec2 k = vec2(1.0, -1.0) * normalEpsilon(t);
+
+    return normalize(
+        k.xyy * map(position + k.xyy) +
+        k.yyx * map(position + k.yyx) +
+        k.yxy * map(position + k.yxy) +
+        k.xxx * map(position + k.xxx)
+    );
+
+#else
+    vec2 d = vec2(normalEpsilon(t), 0.0);
+
+    float gx = map(position + d.xyy) - map(position - d.xyy);
+    float gy = map(position + d.yxy) - map(position - d.yxy);
+    float gz = map(position + d.yyx) - map(position - d.yyx);
+
+    return normalize(vec3(gx, gy, gz));
+#endif
+}
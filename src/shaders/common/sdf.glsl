@@ -0,0 +1,92 @@
+// ------------------ Ray Marching Opperations -----------
+
+
+float smin(float a, float b, float k) {
+    float h = max(k-abs(a-b), 0.0)/k;
+    return min(a,b) - h*h*h*k*(1.0/6.0);
+}
+
+
+// ------------------------- Helpers ---------------------
+
+float circleSDF(vec3 position, float radius) {
+	return length(position) - radius;
+}
+
+float sdBox( vec3 p, vec3 b )
+{
+  vec3 q = abs(p) - b;
+  return length(max(q,0.0)) + min(max(q.x,max(q.y,q.z)),0.0);
+}
+
+float sdCappedCylinder( vec3 p, float h, float r )
+{
+  vec2 d = abs(vec2(length(p.xz),p.y)) - vec2(r,h);
+  return min(max(d.x,d.y),0.0) + length(max(d,0.0));
+}
+
+
+// ------------------ Gradients --------------------------
+// Same shapes returning vec4(distance, gradient), so a normal costs one map() instead of several
+
+
+vec4 circleSDFGradient(vec3 position, float radius) {
+    float l = length(position);
+    return vec4(l - radius, position / max(l, 1e-8));
+}
+
+vec4 sdBoxGradient(vec3 p, vec3 b)
+{
+  vec3 w = abs(p) - b;
+  vec3 s = vec3(p.x < 0.0 ? -1.0 : 1.0, p.y < 0.0 ? -1.0 : 1.0, p.z < 0.0 ? -1.0 : 1.0);
+  float g = max(w.x, max(w.y, w.z));
+  vec3 q = max(w, 0.0);
+  float l = length(q);
+
+  // Outside it points away from the nearest point, inside along the closest face
+  vec3 gradient = (g > 0.0) ? q / l : ((w.x > w.y && w.x > w.z) ? vec3(1.0, 0.0, 0.0) : ((w.y > w.z) ? vec3(0.0, 1.0, 0.0) : vec3(0.0, 0.0, 1.0)));
+
+  return vec4((g > 0.0) ? l : g, s * gradient);
+}
+
+vec4 sdCappedCylinderGradient(vec3 p, float h, float r)
+{
+  float radial = length(p.xz);
+  vec2 d = vec2(radial, abs(p.y)) - vec2(r, h);
+
+  // Out from the axis and up or down the cap
+  vec3 side = vec3(p.x, 0.0, p.z) / max(radial, 1e-8);
+  vec3 cap = vec3(0.0, p.y < 0.0 ? -1.0 : 1.0, 0.0);
+
+  vec2 q = max(d, 0.0);
+  float l = length(q);
+
+  if (l > 0.0) {
+    return vec4(l, (q.x * side + q.y * cap) / l);
+  }
+
+  return vec4(max(d.x, d.y), (d.x > d.y) ? side : cap);
+}
+
+// Gradient versions of the operations, the same as on the distances with the gradient following along
+vec4 unionGradient(vec4 a, vec4 b) {
+    return (a.x < b.x) ? a : b;
+}
+
+vec4 subtractGradient(vec4 a, vec4 b) {
+    return (a.x > -b.x) ? a : -b;
+}
+
+vec4 intersectGradient(vec4 a, vec4 b) {
+    return (a.x > b.x) ? a : b;
+}
+
+vec4 sminGradient(vec4 a, vec4 b, float k) {
+    float h = max(k - abs(a.x - b.x), 0.0) / k;
+
+    // The blend leans on the closer shape, h*h/2 of the other one's gradient mixes in
+    vec4 closer = (a.x < b.x) ? a : b;
+    vec4 further = (a.x < b.x) ? b : a;
+
+    return vec4(closer.x - h * h * h * k * (1.0 / 6.0), mix(closer.yzw, further.yzw, h * h * 0.5));
+}
@@ -10,18 +10,44 @@ uniform float u_mousePosY;
 
 uniform int u_time;
 
-uniform vec3 u_albedo;
-uniform float u_roughness;
-uniform float u_metallic;
-uniform float u_ambient;
+#include "common/math.glsl"
+#include "common/random.glsl"
+#include "common/brdf.glsl"
+#include "common/tonemap.glsl"
+#include "common/camera.glsl"
 
-#define PI 3.14159265359
-#define TWO_PI 6.28318530718
+// Progressive accumulation, WPV sets these when accumulation is on
+uniform bool u_accumulate;
+uniform sampler2D u_accumulation;
+uniform int u_sampleCount;
 
+// Denoising, WPV sets this when the frame goes through the Denoiser instead
+// The color stays linear and the G-buffer below is filled in for its passes
+uniform bool u_denoise;
+
+// The mouse last frame, to find where each hit was on screen then
+uniform vec2 u_previousMousePos;
+
+layout(location = 0) out vec4 fragColor;
+
+// G-buffer (see Denoiser.h), only attached when denoising
+layout(location = 1) out vec4 gNormalDepth; // Normal and distance along the ray, 0 for the background
+layout(location = 2) out vec4 gAlbedo;
+layout(location = 3) out vec4 gMotion; // Pixels moved since last frame and the distance from last frame's camera
+
+// Quality settings, the app can inject its own after #version (see Shader::injectDefines)
+#ifndef MAX_BOUNCES
 #define MAX_BOUNCES 1
+#endif
+
+#ifndef SAMPLES
 #define SAMPLES 3.0
+#endif
 
+// Has to match SCENE_SPHERE_NUM in SceneBlock.h
+#ifndef SPHERE_NUM
 #define SPHERE_NUM 3
+#endif
 
 vec2 u_mouse = vec2(u_mousePosX, u_mousePosY);
 
@@ -43,6 +69,12 @@ struct Sphere {
     RayTracingMaterial material;
 };
 
+// Whole scene, uploaded in one call from SceneBlock.h on the C++ side
+layout(std140) uniform SceneBlock {
+    Sphere u_spheres[SPHERE_NUM];
+    float u_ambient;
+};
+
 // Functional structs
 // Returned from hit functions to give info on an intersection
 struct HitInfo {
@@ -60,34 +92,6 @@ struct Ray {
 };
 
 
-/* Random Values */
-
-uint wang_hash(inout uint seed)
-{
-    seed = uint(seed ^ uint(61)) ^ uint(seed >> uint(16));
-    seed *= uint(9);
-    seed = seed ^ (seed >> 4);
-    seed *= uint(0x27d4eb2d);
-    seed = seed ^ (seed >> 15);
-    return seed;
-}
- 
-float RandomFloat01(inout uint state)
-{
-    return float(wang_hash(state)) / 4294967296.0;
-}
-
-vec3 RandomUnitVector(inout uint state)
-{
-    float z = RandomFloat01(state) * 2.0f - 1.0f;
-    float a = RandomFloat01(state) * TWO_PI;
-    float r = sqrt(1.0f - z * z);
-    float x = r * cos(a);
-    float y = r * sin(a);
-    return vec3(x, y, z);
-}
-
-
 /* --------------------- RAY-OBJECT EQUATIONS ------------------ */
 
 HitInfo intersect(Ray ray, Sphere sphere) {
@@ -159,37 +163,6 @@ HitInfo calculateClosestHit(Ray ray, Sphere spheres[SPHERE_NUM]) {
     return closestHit;
 }
 
-/*---------------------------- COOK-TORRANCE BDRF -----------------------------*/
-
-// N
-// Normal distrubution
-float distributionGGX (vec3 N, vec3 H, float roughness){
-    float a2    = roughness * roughness * roughness * roughness;
-    float NdotH = max (dot (N, H), 0.0);
-    float denom = (NdotH * NdotH * (a2 - 1.0) + 1.0);
-    return a2 / (PI * denom * denom);
-}
-
-// G
-// Geometry
-float geometrySchlickGGX (float NdotV, float roughness){
-    float r = (roughness + 1.0);
-    float k = (r * r) / 8.0;
-    return NdotV / (NdotV * (1.0 - k) + k);
-}
-
-float geometrySmith (vec3 N, vec3 V, vec3 L, float roughness){
-    return geometrySchlickGGX (max (dot (N, L), 0.0), roughness) * 
-           geometrySchlickGGX (max (dot (N, V), 0.0), roughness);
-}
-
-// F
-// Frensel
-vec3 fresnelSchlick (float cosTheta, vec3 F0){
-    return F0 + (1.0 - F0) * pow (1.0 - cosTheta, 5.0);
-}
-
-
 /* ------------------ PBR FUNCTIONS ------------------ */
 
 
@@ -271,28 +244,9 @@ vec3 PBR(Ray ray, Sphere spheres[SPHERE_NUM], uint rngState) {
 
 /* --------------------- Main Function --------------- */
 
-// Rotation matrix for mouse movement
-mat2 rot2D(float angle) {
-    float s = sin(angle);
-    float c = cos(angle);
-    return mat2(c, -s, s, c);
-}
-
 void main() {
 
 
-    /* Camera Setup */
-
-    // Calculate the uv coords and correct aspect ratio
-    vec2 uv = (((gl_FragCoord.xy) / u_resolution) * 2.0 - 1.0) * vec2(u_resolution.x / u_resolution.y, 1.0);
-    vec2 m = (u_mouse.xy * 2.0 - u_resolution.xy) / u_resolution.y;
-
-    // Calculate the angle with the FOV
-    float angle = tan((PI * 0.5 * 30.0) / 180.0);
-    vec2 xy = vec2(angle, angle); // Get the xy components
-    uv *= xy; // Multiply the uv by them
-
-
     /* Other non-ray tracing setup */
 
     int pixelIndex = int(gl_FragCoord.y * u_resolution.x + gl_FragCoord.x);;
@@ -301,71 +255,34 @@ void main() {
     /* Path Tracing Setup */
 
 
-    /* SCENE */
-
-    // Spheres
-    Sphere spheres[SPHERE_NUM]; // Array of all the spheres
-    spheres[0] = Sphere(
-        vec3(3.0, -18.0, 20.0),
-        20.0,
-        RayTracingMaterial(
-            u_albedo,
-            0.0,
-            u_metallic,
-            u_roughness
-        )
-    );
-    spheres[1] = Sphere(
-        vec3(0.0, 0.0, 10.0),
-        2.0,
-        RayTracingMaterial(
-            u_albedo,
-            0.0,
-            u_metallic,
-            1.0
-        )
-    );
-    spheres[2] = Sphere(
-        vec3(-100.0, 0.0, 100.0),
-        80,
-        RayTracingMaterial(
-            vec3(1.0),
-            1.0,
-            0.0,
-            1.0
-        )
-    );
-
-
     /* Ray */
 
-    // Get our ray
-    Ray ray = Ray(
-        vec3(-5.0, 0.0, -10.0), // Orgin at 0,0
-        normalize(vec3(uv, 1.0)) // Direction to the current uv and forward
-    );
-
-    // Apply mouse movement
-
-    float mouseModifier = 3.0;
-
-    if (u_mouseMove) {
-        ray.orgin.xz *= rot2D(-m.x * mouseModifier);
-        ray.direction.xz *= rot2D(-m.x * mouseModifier);
-
-        ray.orgin.yz *= rot2D(m.y * mouseModifier);
-        ray.direction.yz *= rot2D(m.y * mouseModifier);
-    }
+    // Get our ray, turned by the mouse when it's on
+    Ray ray;
+    cameraRay(gl_FragCoord.xy, u_resolution, cameraAngles(u_mouse, u_resolution, u_mouseMove), ray.orgin, ray.direction);
 
     // Find the closest hit
-    HitInfo hit = calculateClosestHit(ray, spheres);
+    HitInfo hit = calculateClosestHit(ray, u_spheres);
+
+    // Nothing for the denoiser to filter
+    gNormalDepth = vec4(0.0);
+    gAlbedo = vec4(0.0);
+    gMotion = vec4(0.0);
 
     // If the ray doesn't hit
     if (!hit.hit) {
-        gl_FragColor = vec4(vec3(0.1647, 0.1765, 0.1765), 1.0);
+        // Already display ready, alpha 0 tells the resolve pass not to tonemap it
+        fragColor = vec4(vec3(0.1647, 0.1765, 0.1765), (u_accumulate || u_denoise) ? 0.0 : 1.0);
         return;
     }
 
+    // Where the hit was on screen last frame, the denoiser follows it to its history
+    vec3 previous = cameraProject(hit.hitPos, u_resolution, cameraAngles(u_previousMousePos, u_resolution, u_mouseMove));
+
+    gNormalDepth = vec4(hit.normal, hit.dist);
+    gAlbedo = vec4(pow(hit.material.albedo, vec3(2.2)), 1.0);
+    gMotion = vec4(gl_FragCoord.xy - previous.xy, previous.z, 0.0);
+
 
     /* PBR & Path Tracing */
     
@@ -379,7 +296,7 @@ void main() {
         rngState = uint(((pixelIndex) * 3014) * (u_time * 3 * (i + 1) * 12));
 
         // Get the PRB calculation for each light
-        Lo += PBR(ray, spheres, rngState) / SAMPLES;
+        Lo += PBR(ray, u_spheres, rngState) / SAMPLES;
     }
 
 
@@ -390,10 +307,22 @@ void main() {
     // Find the color values
     vec3 color = ambient + Lo;  
 
+    // Average with the history and leave the tonemapping to the resolve pass
+    if (u_accumulate) {
+        vec3 history = texelFetch(u_accumulation, ivec2(gl_FragCoord.xy), 0).rgb;
+        fragColor = vec4(mix(history, color, 1.0 / float(u_sampleCount + 1)), 1.0);
+        return;
+    }
+
+    // The denoiser filters and the resolve pass tonemaps
+    if (u_denoise) {
+        fragColor = vec4(color, 1.0);
+        return;
+    }
+
     // Apply HDR and gamma correction
-    color = color / (color + vec3(1.0));
-    color = pow(color, vec3(1.0/2.2)); 
+    color = ReinhardGamma(color);
 
     // Return our final color value
-    gl_FragColor = vec4(color, 1.0);
+    fragColor = vec4(color, 1.0);
 }
@@ -0,0 +1,17 @@
+#version 330 core
+
+// Attributeless fullscreen triangle, pairs with WindowMesh's fullscreen mode
+// Vertices 0, 1, 2 land on (-1, -1), (3, -1), (-1, 3) so one triangle covers the screen
+// with no diagonal seam and no VBO
+
+out vec2 u_resolution;
+
+// Size of what's being rendered, WPV sets it (smaller than the window with dynamic resolution)
+uniform vec2 u_renderSize = vec2(1200.0, 650.0);
+
+void main() {
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+
+    gl_Position = vec4(position, 0.0, 1.0);
+    u_resolution = u_renderSize;
+}
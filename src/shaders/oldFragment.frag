@@ -10,10 +10,29 @@ uniform int u_time;
 uniform float u_mousePosX;
 uniform float u_mousePosY;
 
+// Camera from the scene file
+uniform vec3 u_cameraPosition;
+uniform float u_cameraFov;
+
 vec2 u_mouse = vec2(u_mousePosX, u_mousePosY);
 
-#define PI 3.14159265359
-#define TWO_PI 6.28318530718
+#include "common/math.glsl"
+#include "common/random.glsl"
+#include "common/tonemap.glsl"
+
+// Progressive accumulation, WPV sets these when accumulation is on
+uniform bool u_accumulate;
+uniform sampler2D u_accumulation;
+uniform int u_sampleCount;
+
+// Quality settings, the app can inject its own after #version (see Shader::injectDefines)
+#ifndef MAX_BOUNCES
+#define MAX_BOUNCES 5
+#endif
+
+#ifndef SAMPLES
+#define SAMPLES 1.0
+#endif
 
 struct RayTracingMaterial {
     vec3 color;
@@ -122,282 +141,20 @@ HitInfo intersect( Ray ray, Box box )
     return hit;
 }
 
-mat2 rot2D(float angle) {
-    float s = sin(angle);
-    float c = cos(angle);
-    return mat2(c, -s, s, c);
-}
-
-// ACES tone mapping curve fit to go from HDR to LDR
-//https://knarkowicz.wordpress.com/2016/01/06/aces-filmic-tone-mapping-curve/
-vec3 ACESFilm(vec3 x)
-{
-    float a = 2.51f;
-    float b = 0.03f;
-    float c = 2.43f;
-    float d = 0.59f;
-    float e = 0.14f;
-    return clamp((x*(a*x + b)) / (x*(c*x + d) + e), 0.0f, 1.0f);
-}
-
-uint wang_hash(inout uint seed)
-{
-    seed = uint(seed ^ uint(61)) ^ uint(seed >> uint(16));
-    seed *= uint(9);
-    seed = seed ^ (seed >> 4);
-    seed *= uint(0x27d4eb2d);
-    seed = seed ^ (seed >> 15);
-    return seed;
-}
- 
-float RandomFloat01(inout uint state)
-{
-    return float(wang_hash(state)) / 4294967296.0;
-}
- 
-vec3 RandomUnitVector(inout uint state)
-{
-    float z = RandomFloat01(state) * 2.0f - 1.0f;
-    float a = RandomFloat01(state) * TWO_PI;
-    float r = sqrt(1.0f - z * z);
-    float x = r * cos(a);
-    float y = r * sin(a);
-    return vec3(x, y, z);
-}
-
-vec3 LessThan(vec3 f, float value)
-{
-    return vec3(
-        (f.x < value) ? 1.0f : 0.0f,
-        (f.y < value) ? 1.0f : 0.0f,
-        (f.z < value) ? 1.0f : 0.0f);
-}
- 
-vec3 LinearToSRGB(vec3 rgb)
-{
-    rgb = clamp(rgb, 0.0f, 1.0f);
- 
-    return mix(
-        pow(rgb, vec3(1.0f / 2.4f)) * 1.055f - 0.055f,
-        rgb * 12.92f,
-        LessThan(rgb, 0.0031308f)
-    );
-}
+// The spheres and boxes live in texture buffers now (see PrimitiveScene.cpp), walked with a BVH
+#include "common/bvh.glsl"
 
 HitInfo calculateClosestHit(Ray ray, int depth) {
 
-    Sphere[8] spheres;
-    Box[7] boxes;
-
-    spheres[0] = Sphere(
-        vec3(-3.0, 0.0, -3.0),
-        0.6,
-        RayTracingMaterial(
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.0),
-            0.0,
-            1.0
-        )
-    );
-    spheres[1] = Sphere(
-        vec3(-1.5, 0.0, -3.0),
-        0.6,
-        RayTracingMaterial(
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.0),
-            0.25,
-            1.0
-        )
-    );
-    spheres[2] = Sphere(
-        vec3(0.0, 0.0, -3.0),
-        0.6,
-        RayTracingMaterial(
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.0),
-            0.5,
-            1.0
-        )
-    );
-    spheres[3] = Sphere(
-        vec3(1.5, 0.0, -3.0),
-        0.6,
-        RayTracingMaterial(
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.0),
-            0.75,
-            1.0
-        )
-    );
-    spheres[4] = Sphere(
-        vec3(3.0, 0.0, -3.0),
-        0.6,
-        RayTracingMaterial(
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.3, 1.0, 0.3),
-            vec3(0.0),
-            1.0,
-            1.0
-        )
-    );
-
-    spheres[5] = Sphere(
-        vec3(-2.5, -2.7, -3.0),
-        1.1,
-        RayTracingMaterial(
-            vec3(1.0, 0.9882, 0.3647),
-            vec3(0.9),
-            vec3(0.0),
-            0.2,
-            0.1
-        )
-    );
-    spheres[6] = Sphere(
-        vec3(0.0, -2.7, -3.0),
-        1.1,
-        RayTracingMaterial(
-            vec3(0.97, 0.45, 0.94),
-            vec3(0.9),
-            vec3(0.0),
-            0.2,
-            0.3
-        )
-    );
-
-    spheres[7] = Sphere(
-        vec3(2.5, -2.7, -3.0),
-        1.1,
-        RayTracingMaterial(
-            vec3(0.0, 0.0, 1.0),
-            vec3(1.0, 0.0, 0.0),
-            vec3(0.0),
-            0.5,
-            0.5
-        )
-    );
-
-
-
-    boxes[0] = Box(
-        vec3(-4.0, 0.0, -3.0),
-        vec3(0.1, 4.0, 4.0),
-        RayTracingMaterial(
-            vec3(1.0, 0.0, 0.0),
-            vec3(1.0),
-            vec3(0.0),
-            1.0,
-            0.0
-        )
-    );
-
-    boxes[1] = Box(
-        vec3(0.0, 0.0, -1.0),
-        vec3(4.0, 4.0, 0.1),
-        RayTracingMaterial(
-            vec3(1.0, 1.0, 1.0),
-            vec3(1.0),
-            vec3(0.0),
-            1.0,
-            0.0
-        )
-    );
-
-    boxes[2] = Box(
-        vec3(4.0, 0.0, -3.0),
-        vec3(0.1, 4.0, 4.0),
-        RayTracingMaterial(
-            vec3(0.0, 1.0, 0.0),
-            vec3(1.0),
-            vec3(0.0),
-            1.0,
-            0.0
-        )
-    );
-
-    boxes[3] = Box(
-        vec3(0.0, -4.0, -3.0),
-        vec3(4.0, 0.1, 4.0),
-        RayTracingMaterial(
-            vec3(1.0),
-            vec3(1.0),
-            vec3(0.0),
-            1.0,
-            0.0
-        )
-    );
-
-    boxes[4] = Box(
-        vec3(0.0, 4.0, -3.0),
-        vec3(4.0, 0.1, 4.0),
-        RayTracingMaterial(
-            vec3(1.0, 1.0, 1.0),
-            vec3(1.0),
-            vec3(0.0),
-            1.0,
-            0.0
-        )
-    );
-    boxes[5] = Box(
-        vec3(0.0, 3.9, -4.0),
-        vec3(2.0, 0.1, 2.0),
-        RayTracingMaterial(
-            vec3(1.0, 1.0, 1.0),
-            vec3(1.0),
-            vec3(1.0),
-            1.0,
-            0.0
-        )
-    );
-
-    boxes[6] = Box(
-        vec3(0.0, 0.0, -7.0),
-        vec3(4.0, 4.0, 0.2),
-        RayTracingMaterial(
-            vec3(1.0),
-            vec3(1.0),
-            vec3(0.0),
-            1.0,
-            0.0
-        )
-    );
-
-    HitInfo closestHit;
-    closestHit.hit = false;
-    closestHit.dist = 800000.0;
-
-    for (int i = 0; i < spheres.length(); i++) {
-        HitInfo sphereHit = intersect(ray, spheres[i]);
-
-        if (sphereHit.hit && sphereHit.dist < closestHit.dist) {
-            closestHit = sphereHit;
-        }
-    }
-
-    int ignore = 0;
-    if (depth < 1) { ignore = 1; }
-
-    for (int i = 0; i < boxes.length() - ignore; i++) {
-        HitInfo boxHit = intersect(ray, boxes[i]);
-
-        if (boxHit.hit && boxHit.dist < closestHit.dist) {
-            closestHit = boxHit;
-        }
-    }
-
-    return closestHit;
+    // The front wall is only hidden from the camera
+    return traverseBvh(ray, depth < 1);
 }
 
 vec3 trace(Ray ray, inout uint rngState) {
-    int numBounces = 5;
-
     vec3 colorMult = vec3(1.0);
     vec3 color = vec3(0.0);
 
-    for (int b = 0; b <= numBounces; b++) {
+    for (int b = 0; b <= MAX_BOUNCES; b++) {
 
         HitInfo closestHit = calculateClosestHit(ray, b);
 
@@ -451,14 +208,14 @@ void main() {
 
     vec2 uv = (((gl_FragCoord.xy) / u_resolution) * 2.0 - 1.0) * vec2(u_resolution.x / u_resolution.y, 1.0);
 
-    float angle = tan((PI * 0.5 * 30.0) / 180.0);
+    float angle = tan((PI * 0.5 * u_cameraFov) / 180.0);
     vec2 xy = vec2(angle, angle);
     uv *= xy;
 
     vec2 m = (u_mouse.xy * 2.0 - u_resolution.xy) / u_resolution.y;
 
     Ray ray = Ray(
-        vec3(0.0, 0.0, -20.0),
+        u_cameraPosition,
         normalize(vec3(uv, 1.0))
     );
 
@@ -475,10 +232,18 @@ void main() {
     vec3 color = vec3(0.0);
 
     
-    for (int r = 0; r < 1; r++) {
-        color += trace(ray, rngState) / 1;
+    for (int r = 0; r < SAMPLES; r++) {
+        color += trace(ray, rngState) / SAMPLES;
     }
     color *= 1.0;
+
+    // Average with the history and leave the tonemapping to the resolve pass
+    if (u_accumulate) {
+        vec3 history = texelFetch(u_accumulation, ivec2(gl_FragCoord.xy), 0).rgb;
+        gl_FragColor = vec4(mix(history, color, 1.0 / float(u_sampleCount + 1)), 1.0);
+        return;
+    }
+
     color = ACESFilm(color);
     color = LinearToSRGB(color);
 
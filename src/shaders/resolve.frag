@@ -0,0 +1,39 @@
+#version 330 core
+
+// Shows the accumulation buffer on screen, tonemapping the path traced pixels
+// With dynamic resolution only a corner of it was rendered, which gets scaled up to the window
+
+#include "common/tonemap.glsl"
+
+uniform sampler2D u_accumulation;
+
+// The rendered corner and the window, in pixels
+uniform vec2 u_scaledSize;
+uniform vec2 u_outputSize;
+
+// 0 none, 1 Reinhard + gamma (fragment.frag), 2 ACES + sRGB (oldFragment.frag)
+uniform int u_tonemapper;
+
+out vec4 fragColor;
+
+void main() {
+
+    // Where this pixel lands in the rendered corner (the same texel when nothing is scaled)
+    vec2 position = gl_FragCoord.xy * u_scaledSize / u_outputSize;
+
+    // Bilinear, kept half a texel inside so the stale texels around the corner don't bleed in
+    position = clamp(position, vec2(0.5), u_scaledSize - 0.5);
+
+    vec4 accumulated = texture(u_accumulation, position / vec2(textureSize(u_accumulation, 0)));
+
+    vec3 color = accumulated.rgb;
+
+    if (u_tonemapper == 1) {
+        color = ReinhardGamma(color);
+    } else if (u_tonemapper == 2) {
+        color = LinearToSRGB(ACESFilm(color));
+    }
+
+    // The tracers write alpha 0 for pixels that are already display ready (the background)
+    fragColor = vec4(mix(accumulated.rgb, color, accumulated.a), 1.0);
+}
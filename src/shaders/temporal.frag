@@ -0,0 +1,109 @@
+#version 330 core
+
+// The Denoiser's first pass, blends this frame's noisy trace into the history reprojected from last frame
+// Rays that hit something new (disocclusion) start over, and after a change old history is clamped to what's around
+// the pixel now so it can't drag stale lighting along (ghosting)
+
+// This frame's G-buffer (see fragment.frag)
+uniform sampler2D u_color;
+uniform sampler2D u_normalDepth;
+uniform sampler2D u_motion;
+
+// Last frame's, and its blended result (length of the history in alpha)
+uniform sampler2D u_previousNormalDepth;
+uniform sampler2D u_history;
+uniform bool u_historyValid;
+
+// The rendered corner of the targets, in pixels
+uniform vec2 u_renderSize;
+
+// The newest frame's weight never drops under this, lower is smoother but slower to react
+uniform float u_minBlend;
+
+// How many standard deviations around the neighbourhood's mean the history can be
+uniform float u_clampGamma;
+
+// Only when something changed, a still frame's history is exact and clamping it to one noisy sample's neighbours
+// throws good samples away
+uniform bool u_clampHistory;
+
+// The new history (its length in alpha), and the same color for the filter passes (alpha 0 for display ready pixels)
+layout(location = 0) out vec4 history;
+layout(location = 1) out vec4 frame;
+
+void main() {
+
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+    vec4 color = texelFetch(u_color, pixel, 0);
+    vec4 normalDepth = texelFetch(u_normalDepth, pixel, 0);
+
+    // The background is already display ready
+    if (normalDepth.w <= 0.0) {
+        history = vec4(color.rgb, 0.0);
+        frame = vec4(color.rgb, 0.0);
+        return;
+    }
+
+    // Mean and deviation of the hits around this one
+    vec3 mean = vec3(0.0);
+    vec3 squares = vec3(0.0);
+    float count = 0.0;
+
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+
+            ivec2 neighbour = clamp(pixel + ivec2(x, y), ivec2(0), ivec2(u_renderSize) - 1);
+
+            if (texelFetch(u_normalDepth, neighbour, 0).w <= 0.0) {
+                continue;
+            }
+
+            vec3 neighbourColor = texelFetch(u_color, neighbour, 0).rgb;
+            mean += neighbourColor;
+            squares += neighbourColor * neighbourColor;
+            count += 1.0;
+        }
+    }
+
+    mean /= count;
+    vec3 deviation = sqrt(max(squares / count - mean * mean, 0.0));
+
+    // Where this surface was last frame
+    vec4 motion = texelFetch(u_motion, pixel, 0);
+    vec2 previous = gl_FragCoord.xy - motion.xy;
+
+    vec3 previousColor = color.rgb;
+    float historyLength = 0.0;
+
+    if (u_historyValid && all(greaterThanEqual(previous, vec2(0.0))) && all(lessThan(previous, u_renderSize))) {
+
+        vec4 previousNormalDepth = texelFetch(u_previousNormalDepth, ivec2(previous), 0);
+
+        // The same surface if it was as far from last frame's camera as this point was and faced the same way
+        bool sameSurface = abs(previousNormalDepth.w - motion.z) < 0.05 * motion.z && dot(previousNormalDepth.xyz, normalDepth.xyz) > 0.9;
+
+        if (sameSurface) {
+
+            // Bilinear, kept half a texel inside the corner like the resolve pass
+            vec2 position = clamp(previous, vec2(0.5), u_renderSize - 0.5);
+            vec4 reprojected = texture(u_history, position / vec2(textureSize(u_history, 0)));
+
+            previousColor = reprojected.rgb;
+
+            if (u_clampHistory) {
+                previousColor = clamp(previousColor, mean - deviation * u_clampGamma, mean + deviation * u_clampGamma);
+            }
+            historyLength = reprojected.a;
+        }
+    }
+
+    // A plain average until the history is long enough, then a moving one
+    historyLength += 1.0;
+    float blend = max(1.0 / historyLength, u_minBlend);
+
+    vec3 blended = mix(previousColor, color.rgb, blend);
+
+    history = vec4(blended, historyLength);
+    frame = vec4(blended, 1.0);
+}
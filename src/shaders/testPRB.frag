@@ -8,9 +8,10 @@ uniform float u_mousePosY;
 
 uniform bool u_mouseMove;
 
+#include "common/math.glsl"
+
 vec2 u_mouse = vec2(u_mousePosX, u_mousePosY);
 
-#define PI 3.14159265359
 
 
 /* -------------------------- STRUCTS -------------------------- */
@@ -208,12 +209,6 @@ float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
 
 /* --------------------- Main Function --------------- */
 
-mat2 rot2D(float angle) {
-    float s = sin(angle);
-    float c = cos(angle);
-    return mat2(c, -s, s, c);
-}
-
 void main() {
 
     // Calculate the uv coords and correct aspect ratio
@@ -12,13 +12,17 @@ uniform vec2 u_mouse;
 #define ASPECT_RATIO u_resolution.x / u_resolution.y
 #define FOV 10.0
 
-#define PI 3.14159265359 
-
 #define MAX_STEPS 128
 #define EPSILON 0.001
 #define MAX_DIST 500.0
 
 
+// ----------------------- Includes ----------------------
+
+#include "src/shaders/common/math.glsl"
+#include "src/shaders/common/sdf.glsl"
+
+
 // -------------------- Structs --------------------------
 
 
@@ -28,27 +32,6 @@ struct Ray {
 };
 
 
-// ------------------ Ray Marching Opperations -----------
-
-
-float smin(float a, float b, float k) {
-    float h = max(k-abs(a-b), 0.0)/k;
-    return min(a,b) - h*h*h*k*(1.0/6.0);
-}
-
-
-// ------------------------- Helpers ---------------------
-
-float circleSDF(vec3 position, float radius) {
-	return length(position) - radius;
-}
-
-float sdBox( vec3 p, vec3 b )
-{
-  vec3 q = abs(p) - b;
-  return length(max(q,0.0)) + min(max(q.x,max(q.y,q.z)),0.0);
-}
-
 float map(vec3 position) {
 
     float distOne = circleSDF(position - vec3(0.0, 0.0, 0.0), 1.0);
@@ -62,21 +45,23 @@ float map(vec3 position) {
 
 // ----------------------- Shaders -----------------------
 
-mat2 rot2D(float angle) {
-    float s = sin(angle);
-    float c = cos(angle);
-    return mat2(c, -s, s, c);
-}
+// map() with its gradient, for NORMAL_METHOD 2
+vec4 mapGradient(vec3 position) {
 
-vec3 getNormal(vec3 p) {
-  vec2 d = vec2(0.01, 0.0);
-  float gx = map(p + d.xyy) - map(p - d.xyy);
-  float gy = map(p + d.yxy) - map(p - d.yxy);
-  float gz = map(p + d.yyx) - map(p - d.yyx);
-  vec3 normal = vec3(gx, gy, gz);
-  return normalize(normal);
+    vec4 distOne = circleSDFGradient(position - vec3(0.0, 0.0, 0.0), 1.0);
+
+    // The plane's gradient is its normal everywhere
+    float h = 1.0;
+    vec3 normal = vec3(0.0, 1.0, 0.0);
+    vec4 distTwo = vec4(dot(position, normal) + h, normal);
+
+    return unionGradient(distOne, distTwo);
 }
 
+// A sphere and a plane, the tetrahedron is as good as the full six taps
+#define NORMAL_METHOD 1
+#include "src/shaders/common/normals.glsl"
+
 vec3 render() {
 
     vec2 uv = (gl_FragCoord.xy * 2. - u_resolution.xy) / u_resolution.y;
@@ -109,7 +94,7 @@ vec3 render() {
         t += d;                   // "march" the ray
 
         if (d < .001) {
-            vec3 normal = getNormal(ray.orgin + ray.direction * t);
+            vec3 normal = calculateNormal(ray.orgin + ray.direction * t, t);
 
             vec3 lightColor = vec3(1.0);
             vec3 lightSource = vec3(1.0, 1.0, -1.0);